@@ -0,0 +1,66 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <blockencodings.h>
+#include <consensus/amount.h>
+#include <kernel/mempool_entry.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <txmempool.h>
+#include <util/chaintype.h>
+#include <validation.h>
+
+#include <vector>
+
+static void AddTx(const CTransactionRef& tx, CTxMemPool& pool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, pool.cs)
+{
+    LockPoints lp;
+    pool.addUnchecked(CTxMemPoolEntry(tx, /*fee=*/1000, /*time=*/0, /*entry_height=*/1, /*entry_sequence=*/0, /*spends_coinbase=*/false, /*sigops_cost=*/4, lp));
+}
+
+static CTransactionRef MakeTx(FastRandomContext& det_rand)
+{
+    CMutableTransaction tx;
+    tx.vin.emplace_back(COutPoint{Txid::FromUint256(det_rand.rand256()), 0});
+    tx.vin[0].scriptWitness.stack.push_back(std::vector<unsigned char>(72, 1));
+    tx.vout.emplace_back(COIN, CScript() << OP_0 << std::vector<unsigned char>(20, 2));
+    return MakeTransactionRef(tx);
+}
+
+// Reconstruct a compact block of 3000 transactions, all of which are in a
+// mempool of 100000 transactions.
+static void BlockEncodingsInitData(benchmark::Bench& bench)
+{
+    FastRandomContext det_rand{true};
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN);
+    CTxMemPool& pool = *testing_setup.get()->m_node.mempool;
+
+    CBlock block;
+    block.nBits = 0x207fffff; // A null header is rejected
+    block.vtx.push_back(MakeTx(det_rand));
+    {
+        LOCK2(cs_main, pool.cs);
+        for (int i = 0; i < 100000; ++i) {
+            const CTransactionRef tx{MakeTx(det_rand)};
+            AddTx(tx, pool);
+            if (i % 33 == 0 && block.vtx.size() < 3000) block.vtx.push_back(tx);
+        }
+    }
+    const CBlockHeaderAndShortTxIDs cmpctblock{block};
+    const std::vector<std::pair<uint256, CTransactionRef>> extra_txn;
+
+    bench.unit("block").run([&] {
+        PartiallyDownloadedBlock partial_block{&pool};
+        const ReadStatus status{partial_block.InitData(cmpctblock, extra_txn)};
+        assert(status == READ_STATUS_OK);
+        for (size_t i = 0; i < block.vtx.size(); ++i) assert(partial_block.IsTxAvailable(i));
+    });
+}
+
+BENCHMARK(BlockEncodingsInitData, benchmark::PriorityLevel::HIGH);
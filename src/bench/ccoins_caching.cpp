@@ -4,10 +4,16 @@
 
 #include <bench/bench.h>
 #include <coins.h>
+#include <memusage.h>
 #include <policy/policy.h>
+#include <random.h>
 #include <script/signingprovider.h>
+#include <support/allocators/pool.h>
 #include <test/util/transaction_utils.h>
+#include <tinyformat.h>
 
+#include <algorithm>
+#include <unordered_map>
 #include <vector>
 
 // Microbenchmark for simple accesses to a CCoinsViewCache database. Note from
@@ -51,3 +57,113 @@ static void CCoinsCaching(benchmark::Bench& bench)
 }
 
 BENCHMARK(CCoinsCaching, benchmark::PriorityLevel::HIGH);
+
+namespace {
+constexpr size_t NUM_COINS{100'000};
+
+/** A node-based coins map with a pool allocator, for comparison with the flat CCoinsMap. */
+struct NodeCoinsMap {
+    using Map = std::unordered_map<COutPoint,
+                                   CCoinsCacheEntry,
+                                   SaltedOutpointHasher,
+                                   std::equal_to<COutPoint>,
+                                   PoolAllocator<std::pair<const COutPoint, CCoinsCacheEntry>,
+                                                 sizeof(std::pair<const COutPoint, CCoinsCacheEntry>) + sizeof(void*) * 4>>;
+    Map::allocator_type::ResourceType resource{};
+    Map map{0, SaltedOutpointHasher{/*deterministic=*/true}, Map::key_equal{}, &resource};
+};
+
+struct FlatCoinsMap {
+    CCoinsMap map{SaltedOutpointHasher{/*deterministic=*/true}};
+};
+
+std::vector<COutPoint> RandomOutPoints(size_t count)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        outpoints.emplace_back(Txid::FromUint256(rng.rand256()), rng.randrange(4));
+    }
+    return outpoints;
+}
+
+/** A dirty, fresh P2WPKH output, small enough that its script is not heap allocated. */
+CCoinsCacheEntry MakeEntry(uint32_t height)
+{
+    CTxOut out{/*nValueIn=*/COIN, CScript() << OP_0 << std::vector<unsigned char>(20, 0x42)};
+    return CCoinsCacheEntry{Coin{std::move(out), int(height), /*fCoinBaseIn=*/false}, CCoinsCacheEntry::DIRTY | CCoinsCacheEntry::FRESH};
+}
+
+template <typename Map>
+void Fill(Map& map, const std::vector<COutPoint>& outpoints)
+{
+    for (size_t i = 0; i < outpoints.size(); ++i) {
+        map.emplace(outpoints[i], MakeEntry(i));
+    }
+}
+
+/** Insert NUM_COINS coins into an empty map. The bench name reports the memory used per coin afterwards. */
+template <typename Fixture>
+void CoinsMapInsert(benchmark::Bench& bench)
+{
+    const auto outpoints{RandomOutPoints(NUM_COINS)};
+    {
+        Fixture fixture;
+        Fill(fixture.map, outpoints);
+        bench.name(strprintf("%s (%.1f bytes/coin)", bench.name(), double(memusage::DynamicUsage(fixture.map)) / NUM_COINS));
+    }
+    bench.batch(NUM_COINS).unit("coin").run([&] {
+        Fixture fixture;
+        Fill(fixture.map, outpoints);
+        ankerl::nanobench::doNotOptimizeAway(fixture.map.size());
+    });
+}
+
+/** Look up coins that are all present in the map, in a different order than they were inserted. */
+template <typename Fixture>
+void CoinsMapLookup(benchmark::Bench& bench)
+{
+    auto outpoints{RandomOutPoints(NUM_COINS)};
+    Fixture fixture;
+    Fill(fixture.map, outpoints);
+    std::shuffle(outpoints.begin(), outpoints.end(), FastRandomContext{/*fDeterministic=*/true});
+    bench.batch(NUM_COINS).unit("coin").run([&] {
+        uint64_t height_sum{0};
+        for (const auto& outpoint : outpoints) {
+            height_sum += fixture.map.find(outpoint)->second.coin.nHeight;
+        }
+        ankerl::nanobench::doNotOptimizeAway(height_sum);
+    });
+}
+
+/** Fill a map and drain it the way CCoinsViewDB::BatchWrite does on an erasing flush. */
+template <typename Fixture>
+void CoinsMapFlush(benchmark::Bench& bench)
+{
+    const auto outpoints{RandomOutPoints(NUM_COINS)};
+    bench.batch(NUM_COINS).unit("coin").run([&] {
+        Fixture fixture;
+        Fill(fixture.map, outpoints);
+        size_t dirty{0};
+        for (auto it = fixture.map.begin(); it != fixture.map.end(); it = fixture.map.erase(it)) {
+            if (it->second.flags & CCoinsCacheEntry::DIRTY) ++dirty;
+        }
+        assert(dirty == NUM_COINS && fixture.map.empty());
+    });
+}
+} // namespace
+
+static void CCoinsMapInsertFlat(benchmark::Bench& bench) { CoinsMapInsert<FlatCoinsMap>(bench); }
+static void CCoinsMapInsertNode(benchmark::Bench& bench) { CoinsMapInsert<NodeCoinsMap>(bench); }
+static void CCoinsMapLookupFlat(benchmark::Bench& bench) { CoinsMapLookup<FlatCoinsMap>(bench); }
+static void CCoinsMapLookupNode(benchmark::Bench& bench) { CoinsMapLookup<NodeCoinsMap>(bench); }
+static void CCoinsMapFlushFlat(benchmark::Bench& bench) { CoinsMapFlush<FlatCoinsMap>(bench); }
+static void CCoinsMapFlushNode(benchmark::Bench& bench) { CoinsMapFlush<NodeCoinsMap>(bench); }
+
+BENCHMARK(CCoinsMapInsertFlat, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCoinsMapInsertNode, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCoinsMapLookupFlat, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCoinsMapLookupNode, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCoinsMapFlushFlat, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCoinsMapFlushNode, benchmark::PriorityLevel::HIGH);
@@ -6,7 +6,9 @@
 #include <bench/data.h>
 
 #include <chainparams.h>
+#include <checkqueue.h>
 #include <common/args.h>
+#include <common/system.h>
 #include <consensus/validation.h>
 #include <streams.h>
 #include <util/chaintype.h>
@@ -51,5 +53,27 @@ static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
     });
 }
 
+static void CheckBlockParallelTest(benchmark::Bench& bench)
+{
+    // We shouldn't ever be running with the checkqueue on a single core machine.
+    if (GetNumCores() <= 1) return;
+
+    DataStream stream(benchmark::data::block413567);
+    CBlock block;
+    stream >> TX_WITH_WITNESS(block);
+
+    ArgsManager bench_args;
+    const auto chainParams = CreateChainParams(bench_args, ChainType::MAIN);
+    CCheckQueue<CBlockTxCheck> queue{/*batch_size=*/32, GetNumCores() - 1};
+
+    bench.unit("block").run([&] {
+        block.fChecked = false; // CBlock caches its checked state
+        BlockValidationState validationState;
+        bool checked = CheckBlock(block, validationState, chainParams->GetConsensus(), /*fCheckPOW=*/true, /*fCheckMerkleRoot=*/true, &queue);
+        assert(checked);
+    });
+}
+
 BENCHMARK(DeserializeBlockTest, benchmark::PriorityLevel::HIGH);
 BENCHMARK(DeserializeAndCheckBlockTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CheckBlockParallelTest, benchmark::PriorityLevel::HIGH);
@@ -5,6 +5,7 @@
 #include <bench/bench.h>
 #include <checkqueue.h>
 #include <common/system.h>
+#include <crypto/sha256.h>
 #include <key.h>
 #include <prevector.h>
 #include <pubkey.h>
@@ -65,3 +66,54 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
     ECC_Stop();
 }
 BENCHMARK(CCheckQueueSpeedPrevectorJob, benchmark::PriorityLevel::HIGH);
+
+// This Benchmark tests how the CheckQueue scales with the number of threads,
+// with checks that do a little work, roughly like a cheap signature check. On
+// a machine with fewer cores than threads it shows the scheduling overhead.
+static void CCheckQueueScaling(benchmark::Bench& bench, int threads)
+{
+    struct HashJob {
+        uint8_t data[64]{};
+        bool operator()()
+        {
+            uint8_t out[CSHA256::OUTPUT_SIZE];
+            for (int i = 0; i < 16; ++i) {
+                CSHA256().Write(data, sizeof(data)).Finalize(out);
+                data[i] = out[0];
+            }
+            return true;
+        }
+    };
+
+    CCheckQueue<HashJob> queue{QUEUE_BATCH_SIZE, threads - 1};
+
+    // One batch per transaction, with a few inputs each.
+    std::vector<std::vector<HashJob>> vBatches(BATCHES * 10);
+    for (auto& vChecks : vBatches) {
+        vChecks.resize(3);
+    }
+
+    bench.minEpochIterations(10).batch(vBatches.size() * 3).unit("job").run([&] {
+        CCheckQueueControl<HashJob> control(&queue);
+        for (auto vChecks : vBatches) {
+            control.Add(std::move(vChecks));
+        }
+        control.Wait();
+    });
+}
+
+static void CCheckQueueScaling1(benchmark::Bench& bench) { CCheckQueueScaling(bench, 1); }
+static void CCheckQueueScaling2(benchmark::Bench& bench) { CCheckQueueScaling(bench, 2); }
+static void CCheckQueueScaling4(benchmark::Bench& bench) { CCheckQueueScaling(bench, 4); }
+static void CCheckQueueScaling8(benchmark::Bench& bench) { CCheckQueueScaling(bench, 8); }
+static void CCheckQueueScaling16(benchmark::Bench& bench) { CCheckQueueScaling(bench, 16); }
+static void CCheckQueueScaling32(benchmark::Bench& bench) { CCheckQueueScaling(bench, 32); }
+static void CCheckQueueScaling64(benchmark::Bench& bench) { CCheckQueueScaling(bench, 64); }
+
+BENCHMARK(CCheckQueueScaling1, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCheckQueueScaling2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCheckQueueScaling4, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCheckQueueScaling8, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCheckQueueScaling16, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCheckQueueScaling32, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCheckQueueScaling64, benchmark::PriorityLevel::HIGH);
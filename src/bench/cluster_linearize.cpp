@@ -0,0 +1,43 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <cluster_linearize.h>
+#include <random.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace cluster_linearize;
+
+static void LinearizeCluster(benchmark::Bench& bench, uint32_t n, bool chain)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<FeeFrac> feerates;
+    std::vector<std::vector<uint32_t>> parents(n);
+    for (uint32_t i{0}; i < n; ++i) {
+        feerates.emplace_back(rng.randrange(100000), 60 + rng.randrange(1000));
+        if (chain) {
+            if (i > 0) parents[i].push_back(i - 1);
+        } else {
+            for (uint32_t j{0}; j < i; ++j) {
+                if (rng.randrange(i) < 2) parents[i].push_back(j);
+            }
+        }
+    }
+
+    bench.run([&] {
+        const auto linearization{Linearize(feerates, parents)};
+        const auto chunks{ChunkLinearization(feerates, linearization)};
+        ankerl::nanobench::doNotOptimizeAway(chunks);
+    });
+}
+
+static void LinearizeChain25(benchmark::Bench& bench) { LinearizeCluster(bench, 25, /*chain=*/true); }
+static void LinearizeRandom25(benchmark::Bench& bench) { LinearizeCluster(bench, 25, /*chain=*/false); }
+static void LinearizeRandom100(benchmark::Bench& bench) { LinearizeCluster(bench, 100, /*chain=*/false); }
+
+BENCHMARK(LinearizeChain25, benchmark::PriorityLevel::HIGH);
+BENCHMARK(LinearizeRandom25, benchmark::PriorityLevel::HIGH);
+BENCHMARK(LinearizeRandom100, benchmark::PriorityLevel::HIGH);
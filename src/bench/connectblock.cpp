@@ -0,0 +1,91 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/validation.h>
+#include <key.h>
+#include <primitives/transaction.h>
+#include <pubkey.h>
+#include <random.h>
+#include <script/interpreter.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <cassert>
+#include <vector>
+
+/**
+ * Connect a block of Taproot key path spends on top of the active chain, the
+ * way a block received from a peer is connected (without storing script
+ * checks or signatures in the caches). As with checkblock.cpp, this is the
+ * work that happens after a block has been received.
+ */
+static void ConnectBlockTaproot(benchmark::Bench& bench)
+{
+    const auto test_setup{MakeNoLogFileContext<TestChain100Setup>(ChainType::REGTEST)};
+    ChainstateManager& chainman{*test_setup->m_node.chainman};
+    Chainstate& chainstate{chainman.ActiveChainstate()};
+
+    CKey key;
+    key.MakeNewKey(true);
+    const XOnlyPubKey output_key{XOnlyPubKey{key.GetPubKey()}.CreateTapTweak(nullptr)->first};
+    const CScript taproot_script{CScript() << OP_1 << ToByteVector(output_key)};
+    const CScript coinbase_script{CScript() << ToByteVector(test_setup->coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+
+    // Fund the Taproot outputs from the mature coinbases.
+    constexpr size_t NUM_FUNDING_TXS{10};
+    constexpr size_t OUTPUTS_PER_TX{100};
+    test_setup->mineBlocks(NUM_FUNDING_TXS);
+    std::vector<CMutableTransaction> funding_txs;
+    for (size_t i{0}; i < NUM_FUNDING_TXS; ++i) {
+        const CTransactionRef& coinbase{test_setup->m_coinbase_txns[i]};
+        const CAmount value{(coinbase->vout[0].nValue - 1000) / CAmount{OUTPUTS_PER_TX}};
+        funding_txs.push_back(test_setup->CreateValidMempoolTransaction({coinbase}, {COutPoint{coinbase->GetHash(), 0}}, /*input_height=*/i + 1,
+                                                                        {test_setup->coinbaseKey}, std::vector<CTxOut>(OUTPUTS_PER_TX, CTxOut{value, taproot_script}),
+                                                                        /*submit=*/false));
+    }
+    test_setup->CreateAndProcessBlock(funding_txs, coinbase_script);
+
+    // Spend each of them with a key path signature.
+    std::vector<CMutableTransaction> spends;
+    for (const CMutableTransaction& funding_tx : funding_txs) {
+        for (uint32_t n{0}; n < funding_tx.vout.size(); ++n) {
+            CMutableTransaction spend;
+            spend.vin.emplace_back(COutPoint{funding_tx.GetHash(), n});
+            spend.vout.emplace_back(funding_tx.vout[n].nValue - 1000, taproot_script);
+
+            PrecomputedTransactionData txdata;
+            txdata.Init(spend, {funding_tx.vout[n]}, /*force=*/true);
+            ScriptExecutionData execdata;
+            execdata.m_annex_init = true;
+            execdata.m_annex_present = false;
+            uint256 sighash;
+            const bool hashed{SignatureHashSchnorr(sighash, execdata, spend, 0, SIGHASH_DEFAULT, SigVersion::TAPROOT, txdata, MissingDataBehavior::FAIL)};
+            assert(hashed);
+            std::vector<unsigned char> sig(64);
+            const bool signed_ok{key.SignSchnorr(sighash, sig, &uint256::ZERO, GetRandHash())};
+            assert(signed_ok);
+            spend.vin[0].scriptWitness.stack.push_back(std::move(sig));
+            spends.push_back(std::move(spend));
+        }
+    }
+    const CBlock block{test_setup->CreateBlock(spends, coinbase_script, chainstate)};
+
+    BlockValidationState state;
+    const CBlockIndex* pindex{nullptr};
+    const bool accepted{chainman.ProcessNewBlockHeaders({block}, /*min_pow_checked=*/true, state, &pindex)};
+    assert(accepted);
+
+    bench.unit("block").minEpochIterations(5).run([&] {
+        LOCK(cs_main);
+        CCoinsViewCache view{&chainstate.CoinsTip()};
+        BlockValidationState block_state;
+        const bool connected{chainstate.ConnectBlock(block, block_state, const_cast<CBlockIndex*>(pindex), view)};
+        assert(connected);
+    });
+}
+
+BENCHMARK(ConnectBlockTaproot, benchmark::PriorityLevel::HIGH);
@@ -178,6 +178,39 @@ static void SHA256D64_1024_SHANI(benchmark::Bench& bench)
     SHA256AutoDetect();
 }
 
+static void SHA256D64_1024_AVX512(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AND_AVX512)));
+    std::vector<uint8_t> in(64 * 1024, 0);
+    bench.batch(in.size()).unit("byte").run([&] {
+        SHA256D64(in.data(), in.data(), 1024);
+    });
+    SHA256AutoDetect();
+}
+
+/* Double-SHA256 of 1024 transaction-sized messages, one at a time. */
+static void SHA256D_250b_1024(benchmark::Bench& bench)
+{
+    std::vector<uint8_t> in(250 * 1024, 0), out(32 * 1024);
+    bench.batch(1024).unit("hash").run([&] {
+        for (size_t i = 0; i < 1024; ++i) {
+            CHash256().Write({in.data() + 250 * i, 250}).Finalize({out.data() + 32 * i, 32});
+        }
+    });
+}
+
+/* Double-SHA256 of 1024 transaction-sized messages, interleaved across SIMD lanes. */
+static void SHA256DMany_250b_1024(benchmark::Bench& bench)
+{
+    std::vector<uint8_t> in(250 * 1024, 0), out(32 * 1024);
+    std::vector<const unsigned char*> inputs(1024);
+    std::vector<size_t> lengths(1024, 250);
+    for (size_t i = 0; i < 1024; ++i) inputs[i] = in.data() + 250 * i;
+    bench.batch(1024).unit("hash").run([&] {
+        SHA256DMany(out.data(), inputs.data(), lengths.data(), 1024);
+    });
+}
+
 static void SHA512(benchmark::Bench& bench)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -274,6 +307,9 @@ BENCHMARK(SHA256D64_1024_STANDARD, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_SSE4, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_AVX2, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_SHANI, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256D64_1024_AVX512, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256D_250b_1024, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256DMany_250b_1024, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FastRandom_32bit, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FastRandom_1bit, benchmark::PriorityLevel::HIGH);
 
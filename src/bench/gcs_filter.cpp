@@ -5,6 +5,10 @@
 #include <bench/bench.h>
 #include <blockfilter.h>
 
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
 static GCSFilter::ElementSet GenerateGCSTestElements()
 {
     GCSFilter::ElementSet elements;
@@ -81,8 +85,65 @@ static void GCSFilterMatch(benchmark::Bench& bench)
         filter.Match(GCSFilter::Element());
     });
 }
+// Match a wallet's worth of scripts (10,000) against filters of blocks with
+// 2,000 elements each, none of which match.
+static std::vector<GCSFilter> GenerateBlockFilters(size_t count)
+{
+    std::vector<GCSFilter> filters;
+    for (size_t n = 0; n < count; ++n) {
+        GCSFilter::ElementSet elements;
+        for (int i = 0; i < 2000; ++i) {
+            GCSFilter::Element element(25);
+            element[0] = static_cast<unsigned char>(n);
+            element[1] = static_cast<unsigned char>(i);
+            element[2] = static_cast<unsigned char>(i >> 8);
+            elements.insert(std::move(element));
+        }
+        filters.emplace_back(GCSFilter::Params{n, n, BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+    }
+    return filters;
+}
+
+static GCSFilter::ElementSet GenerateWalletElements()
+{
+    GCSFilter::ElementSet elements;
+    for (int i = 0; i < 10000; ++i) {
+        GCSFilter::Element element(22, 0xff);
+        element[0] = static_cast<unsigned char>(i);
+        element[1] = static_cast<unsigned char>(i >> 8);
+        elements.insert(std::move(element));
+    }
+    return elements;
+}
+
+static void GCSFilterMatchAny(benchmark::Bench& bench)
+{
+    const auto filters = GenerateBlockFilters(1);
+    const auto elements = GenerateWalletElements();
+
+    bench.run([&] {
+        bool match = filters[0].MatchAny(elements);
+        assert(!match);
+    });
+}
+
+static void GCSFilterMatchAnyMany(benchmark::Bench& bench)
+{
+    const auto filters = GenerateBlockFilters(16);
+    const auto elements = GenerateWalletElements();
+    std::vector<const GCSFilter*> filter_ptrs;
+    for (const auto& filter : filters) filter_ptrs.push_back(&filter);
+
+    bench.unit("filter").batch(filters.size()).run([&] {
+        const auto matches = GCSFilter::MatchAnyMany(filter_ptrs, elements);
+        assert(std::find(matches.begin(), matches.end(), true) == matches.end());
+    });
+}
+
 BENCHMARK(GCSBlockFilterGetHash, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterConstruct, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterDecode, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterDecodeSkipCheck, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterMatch, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GCSFilterMatchAny, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GCSFilterMatchAnyMany, benchmark::PriorityLevel::HIGH);
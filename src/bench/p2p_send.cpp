@@ -0,0 +1,81 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <compat/compat.h>
+#include <net.h>
+#include <netmessagemaker.h>
+#include <protocol.h>
+#include <random.h>
+#include <span.h>
+#include <test/util/setup_common.h>
+#include <util/sock.h>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#ifndef WIN32
+#include <sys/socket.h>
+
+static constexpr size_t NUM_MESSAGES{32};
+static constexpr size_t MESSAGE_SIZE{250};
+
+/**
+ * Push a burst of transaction-sized messages through a V1Transport onto a
+ * loopback socket, either one Send() per header/payload chunk or with a single
+ * vectored SendMany() for everything queued in the transport.
+ */
+static void P2PSend(benchmark::Bench& bench, bool vectored)
+{
+    const auto testing_setup = MakeNoLogFileContext<const BasicTestingSetup>();
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    const Sock sender(fds[0]);
+    const Sock receiver(fds[1]);
+
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const CSerializedNetMsg msg{NetMsg::Make(NetMsgType::TX, Span{rng.randbytes<uint8_t>(MESSAGE_SIZE)})};
+    V1Transport transport{0};
+    std::vector<Transport::SendSpan> spans;
+    std::vector<Span<const unsigned char>> buffers;
+    std::vector<uint8_t> recv_buf(NUM_MESSAGES * (CMessageHeader::HEADER_SIZE + MESSAGE_SIZE));
+
+    bench.batch(NUM_MESSAGES).unit("msg").run([&] {
+        for (size_t i{0}; i < NUM_MESSAGES; ++i) {
+            CSerializedNetMsg copy{msg.Copy()};
+            assert(transport.SetMessageToSend(copy));
+        }
+        while (true) {
+            ssize_t sent;
+            if (vectored) {
+                spans.clear();
+                (void)transport.GetBytesToSendMany(/*have_next_message=*/false, MAX_SEND_SPANS, spans);
+                if (spans.empty()) break;
+                buffers.clear();
+                for (const auto& span : spans) buffers.push_back(span.data);
+                sent = sender.SendMany(buffers, MSG_NOSIGNAL);
+            } else {
+                const auto& [data, _more, _msg_type] = transport.GetBytesToSend(/*have_next_message=*/false);
+                if (data.empty()) break;
+                sent = sender.Send(data.data(), data.size(), MSG_NOSIGNAL);
+            }
+            assert(sent > 0);
+            transport.MarkBytesSent(sent);
+        }
+        size_t received{0};
+        while (received < recv_buf.size()) {
+            const ssize_t ret{receiver.Recv(recv_buf.data() + received, recv_buf.size() - received, 0)};
+            assert(ret > 0);
+            received += ret;
+        }
+    });
+}
+
+static void P2PSendOneByOne(benchmark::Bench& bench) { P2PSend(bench, /*vectored=*/false); }
+static void P2PSendVectored(benchmark::Bench& bench) { P2PSend(bench, /*vectored=*/true); }
+
+BENCHMARK(P2PSendOneByOne, benchmark::PriorityLevel::HIGH);
+BENCHMARK(P2PSendVectored, benchmark::PriorityLevel::HIGH);
+#endif // WIN32
@@ -9,21 +9,31 @@
 #include <node/blockstorage.h>
 #include <streams.h>
 #include <test/util/setup_common.h>
+#include <sync.h>
 #include <util/chaintype.h>
 #include <validation.h>
 
+#include <cassert>
+#include <vector>
+
 static FlatFilePos WriteBlockToDisk(ChainstateManager& chainman)
 {
     DataStream stream{benchmark::data::block413567};
     CBlock block;
     stream >> TX_WITH_WITNESS(block);
 
-    return chainman.m_blockman.SaveBlockToDisk(block, 0, nullptr);
+    const FlatFilePos pos{chainman.m_blockman.SaveBlockToDisk(block, 0, nullptr)};
+    // Move on to a new block file, so that the file holding the block is
+    // finalized and can be memory-mapped.
+    WITH_LOCK(::cs_main, chainman.m_blockman.GetBlockFileInfo(pos.nFile)->nSize = node::MAX_BLOCKFILE_SIZE);
+    const FlatFilePos next_pos{chainman.m_blockman.SaveBlockToDisk(block, 1, nullptr)};
+    assert(next_pos.nFile != pos.nFile);
+    return pos;
 }
 
-static void ReadBlockFromDiskTest(benchmark::Bench& bench)
+static void ReadBlockFromDisk(benchmark::Bench& bench, const std::vector<const char*>& extra_args)
 {
-    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN, extra_args)};
     ChainstateManager& chainman{*testing_setup->m_node.chainman};
 
     CBlock block;
@@ -35,9 +45,9 @@ static void ReadBlockFromDiskTest(benchmark::Bench& bench)
     });
 }
 
-static void ReadRawBlockFromDiskTest(benchmark::Bench& bench)
+static void ReadRawBlockFromDisk(benchmark::Bench& bench, const std::vector<const char*>& extra_args)
 {
-    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN, extra_args)};
     ChainstateManager& chainman{*testing_setup->m_node.chainman};
 
     std::vector<uint8_t> block_data;
@@ -49,5 +59,31 @@ static void ReadRawBlockFromDiskTest(benchmark::Bench& bench)
     });
 }
 
+static void MapRawBlockTest(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN, {"-blocksmmap=1"})};
+    ChainstateManager& chainman{*testing_setup->m_node.chainman};
+
+    const auto pos{WriteBlockToDisk(chainman)};
+
+    bench.run([&] {
+        const auto mapped_block{chainman.m_blockman.MapRawBlock(pos)};
+        assert(mapped_block);
+        ankerl::nanobench::doNotOptimizeAway(mapped_block->data.size());
+    });
+}
+
+static void ReadBlockFromDiskTest(benchmark::Bench& bench) { ReadBlockFromDisk(bench, {}); }
+static void ReadBlockFromDiskMmapTest(benchmark::Bench& bench) { ReadBlockFromDisk(bench, {"-blocksmmap=1"}); }
+static void ReadBlockFromDiskCachedTest(benchmark::Bench& bench) { ReadBlockFromDisk(bench, {"-blockcachesize=32"}); }
+static void ReadRawBlockFromDiskTest(benchmark::Bench& bench) { ReadRawBlockFromDisk(bench, {}); }
+static void ReadRawBlockFromDiskMmapTest(benchmark::Bench& bench) { ReadRawBlockFromDisk(bench, {"-blocksmmap=1"}); }
+static void ReadRawBlockFromDiskCachedTest(benchmark::Bench& bench) { ReadRawBlockFromDisk(bench, {"-blockcachesize=32"}); }
+
 BENCHMARK(ReadBlockFromDiskTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReadBlockFromDiskMmapTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReadBlockFromDiskCachedTest, benchmark::PriorityLevel::HIGH);
 BENCHMARK(ReadRawBlockFromDiskTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReadRawBlockFromDiskMmapTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReadRawBlockFromDiskCachedTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MapRawBlockTest, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,99 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <kernel/chainstatemanager_opts.h>
+#include <node/blockstorage.h>
+#include <node/kernel_notifications.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/script.h>
+#include <test/util/setup_common.h>
+#include <util/check.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace {
+/** Keeps the block index on disk, so that the chain survives a restart. */
+struct ReindexTestingSetup : public TestChain100Setup {
+    ReindexTestingSetup(const ChainType chain_type, const std::vector<const char*>& extra_args)
+        : TestChain100Setup{chain_type, extra_args, /*coins_db_in_memory=*/true, /*block_tree_db_in_memory=*/false} {}
+};
+} // namespace
+
+/**
+ * Restart the node with -reindex-chainstate and time how long it takes to
+ * connect all blocks from disk again, the way blocks are connected during
+ * IBD.
+ */
+static void ReindexChainstate(benchmark::Bench& bench, int block_read_ahead)
+{
+    const auto test_setup{MakeNoLogFileContext<ReindexTestingSetup>()};
+    node::NodeContext& node{test_setup->m_node};
+
+    // Every block fans a coinbase out to TXS_PER_BLOCK outputs, and spends the
+    // outputs of the previous fan-out.
+    constexpr size_t NUM_BLOCKS{COINBASE_MATURITY};
+    constexpr size_t TXS_PER_BLOCK{200};
+    CMutableTransaction prev_fanout;
+    for (size_t b{0}; b < NUM_BLOCKS; ++b) {
+        const CTransactionRef& coinbase{test_setup->m_coinbase_txns[b]};
+        const CAmount value{coinbase->vout[0].nValue / CAmount{TXS_PER_BLOCK}};
+        std::vector<CMutableTransaction> txs;
+        txs.push_back(test_setup->CreateValidMempoolTransaction({coinbase}, {COutPoint{coinbase->GetHash(), 0}}, /*input_height=*/b + 1,
+                                                                {test_setup->coinbaseKey}, std::vector<CTxOut>(TXS_PER_BLOCK, CTxOut{value, P2WSH_OP_TRUE}),
+                                                                /*submit=*/false));
+        for (uint32_t n{0}; n < prev_fanout.vout.size(); ++n) {
+            CMutableTransaction& tx{txs.emplace_back()};
+            tx.vin.emplace_back(COutPoint{prev_fanout.GetHash(), n});
+            tx.vin.back().scriptWitness.stack.push_back(WITNESS_STACK_ELEM_OP_TRUE);
+            tx.vout.emplace_back(prev_fanout.vout[n].nValue, P2WSH_OP_TRUE);
+        }
+        prev_fanout = txs.front();
+        test_setup->CreateAndProcessBlock(txs, P2WSH_OP_TRUE);
+    }
+    const int height{WITH_LOCK(cs_main, return node.chainman->ActiveHeight())};
+    assert(height == int{COINBASE_MATURITY + NUM_BLOCKS});
+
+    test_setup->m_args.ForceSetArg("-reindex-chainstate", "1");
+    bench.unit("block").batch(height).run([&] {
+        {
+            LOCK(cs_main);
+            node.chainman->ActiveChainstate().ForceFlushStateToDisk();
+        }
+        SyncWithValidationInterfaceQueue();
+        {
+            LOCK(cs_main);
+            node.chainman->ResetChainstates();
+        }
+        const ChainstateManager::Options chainman_opts{
+            .chainparams = ::Params(),
+            .datadir = node.chainman->m_options.datadir,
+            .notifications = *node.notifications,
+            .worker_threads_num = 2,
+            .block_read_ahead = block_read_ahead,
+        };
+        const node::BlockManager::Options blockman_opts{
+            .chainparams = chainman_opts.chainparams,
+            .blocks_dir = test_setup->m_args.GetBlocksDirPath(),
+            .notifications = chainman_opts.notifications,
+        };
+        node.chainman.reset();
+        node.chainman = std::make_unique<ChainstateManager>(*Assert(node.shutdown), chainman_opts, blockman_opts);
+        test_setup->LoadVerifyActivateChainstate();
+        assert(WITH_LOCK(cs_main, return node.chainman->ActiveHeight()) == height);
+    });
+}
+
+static void ReindexChainstateSequential(benchmark::Bench& bench) { ReindexChainstate(bench, /*block_read_ahead=*/0); }
+static void ReindexChainstateReadAhead(benchmark::Bench& bench) { ReindexChainstate(bench, /*block_read_ahead=*/2); }
+
+BENCHMARK(ReindexChainstateSequential, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReindexChainstateReadAhead, benchmark::PriorityLevel::HIGH);
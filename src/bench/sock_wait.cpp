@@ -0,0 +1,66 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <compat/compat.h>
+#include <random.h>
+#include <util/fs_helpers.h>
+#include <util/sock.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#ifndef WIN32
+#include <sys/socket.h>
+
+/**
+ * Wait on many mostly idle loopback connections, of which one receives a byte
+ * in every iteration, like the socket handler thread does with many peers.
+ */
+static void SockWait(benchmark::Bench& bench, int num_pairs, bool wait_set)
+{
+    num_pairs = std::min(num_pairs, (RaiseFileDescriptorLimit(2 * num_pairs + 100) - 100) / 2);
+    std::vector<std::shared_ptr<const Sock>> waited;
+    std::vector<std::unique_ptr<Sock>> peers;
+    for (int i{0}; i < num_pairs; ++i) {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) break;
+        waited.push_back(std::make_shared<const Sock>(fds[0]));
+        peers.push_back(std::make_unique<Sock>(fds[1]));
+    }
+
+    FastRandomContext rng{/*fDeterministic=*/true};
+    SockWaitSet sock_wait_set;
+    bench.run([&] {
+        const size_t i{rng.randrange(waited.size())};
+        const uint8_t byte{0};
+        (void)peers[i]->Send(&byte, 1, 0);
+
+        Sock::EventsPerSock events_per_sock;
+        for (const auto& sock : waited) {
+            events_per_sock.emplace(sock, Sock::Events{Sock::RECV});
+        }
+        const bool ok{wait_set ? sock_wait_set.WaitMany(std::chrono::seconds{1}, events_per_sock) :
+                                 events_per_sock.begin()->first->WaitMany(std::chrono::seconds{1}, events_per_sock)};
+        assert(ok && (events_per_sock.at(waited[i]).occurred & Sock::RECV));
+
+        uint8_t received;
+        (void)waited[i]->Recv(&received, 1, 0);
+    });
+}
+
+static void SockWaitMany100(benchmark::Bench& bench) { SockWait(bench, 100, /*wait_set=*/false); }
+static void SockWaitMany1000(benchmark::Bench& bench) { SockWait(bench, 1000, /*wait_set=*/false); }
+static void SockWaitSet100(benchmark::Bench& bench) { SockWait(bench, 100, /*wait_set=*/true); }
+static void SockWaitSet1000(benchmark::Bench& bench) { SockWait(bench, 1000, /*wait_set=*/true); }
+
+BENCHMARK(SockWaitMany100, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SockWaitMany1000, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SockWaitSet100, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SockWaitSet1000, benchmark::PriorityLevel::HIGH);
+#endif // WIN32
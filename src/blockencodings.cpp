@@ -15,6 +15,8 @@
 #include <txmempool.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <bit>
 #include <unordered_map>
 
 CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block) :
@@ -45,6 +47,11 @@ uint64_t CBlockHeaderAndShortTxIDs::GetShortID(const uint256& txhash) const {
     return SipHashUint256(shorttxidk0, shorttxidk1, txhash) & 0xffffffffffffL;
 }
 
+void CBlockHeaderAndShortTxIDs::GetShortIDs(Span<const uint256> txhashes, uint64_t* out) const {
+    SipHashUint256Many(shorttxidk0, shorttxidk1, txhashes, out);
+    for (size_t i = 0; i < txhashes.size(); ++i) out[i] &= 0xffffffffffffL;
+}
+
 
 
 ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<uint256, CTransactionRef>>& extra_txn) {
@@ -104,32 +111,52 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     if (shorttxids.size() != cmpctblock.shorttxids.size())
         return READ_STATUS_FAILED; // Short ID collision
 
+    // Bit filter over the short IDs, so that the mempool scan below rarely needs to
+    // look up the transactions which are not in the block in shorttxids. With 16
+    // bits per short ID, about 6% of the lookups are false positives.
+    const size_t filter_bits{std::bit_ceil(std::max<size_t>(cmpctblock.shorttxids.size() * 16, 64))};
+    std::vector<uint64_t> filter(filter_bits / 64);
+    for (const uint64_t shortid : cmpctblock.shorttxids) {
+        filter[(shortid & (filter_bits - 1)) / 64] |= uint64_t{1} << (shortid % 64);
+    }
+
     std::vector<bool> have_txn(txn_available.size());
     {
     LOCK(pool->cs);
-    for (const auto& tx : pool->txns_randomized) {
-        uint64_t shortid = cmpctblock.GetShortID(tx->GetWitnessHash());
-        std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
-        if (idit != shorttxids.end()) {
-            if (!have_txn[idit->second]) {
-                txn_available[idit->second] = tx;
-                have_txn[idit->second]  = true;
-                mempool_count++;
-            } else {
-                // If we find two mempool txn that match the short id, just request it.
-                // This should be rare enough that the extra bandwidth doesn't matter,
-                // but eating a round-trip due to FillBlock failure would be annoying
-                if (txn_available[idit->second]) {
-                    txn_available[idit->second].reset();
-                    mempool_count--;
+    // Compute the short IDs of the mempool in batches, from the contiguous array
+    // of witness hashes rather than from the transactions themselves, which would
+    // cost a cache miss each.
+    constexpr size_t SHORTID_BATCH{64};
+    uint64_t batch_shortids[SHORTID_BATCH];
+    const Span<const uint256> wtxids{pool->wtxids_randomized};
+    for (size_t start = 0; start < wtxids.size() && mempool_count < shorttxids.size(); start += SHORTID_BATCH) {
+        const size_t batch_size{std::min(SHORTID_BATCH, wtxids.size() - start)};
+        cmpctblock.GetShortIDs(wtxids.subspan(start, batch_size), batch_shortids);
+        for (size_t i = 0; i < batch_size; i++) {
+            const uint64_t shortid = batch_shortids[i];
+            if (!((filter[(shortid & (filter_bits - 1)) / 64] >> (shortid % 64)) & 1)) continue;
+            std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
+            if (idit != shorttxids.end()) {
+                if (!have_txn[idit->second]) {
+                    txn_available[idit->second] = pool->txns_randomized[start + i];
+                    have_txn[idit->second]  = true;
+                    mempool_count++;
+                } else {
+                    // If we find two mempool txn that match the short id, just request it.
+                    // This should be rare enough that the extra bandwidth doesn't matter,
+                    // but eating a round-trip due to FillBlock failure would be annoying
+                    if (txn_available[idit->second]) {
+                        txn_available[idit->second].reset();
+                        mempool_count--;
+                    }
                 }
             }
+            // Though ideally we'd continue scanning for the two-txn-match-shortid case,
+            // the performance win of an early exit here is too good to pass up and worth
+            // the extra risk.
+            if (mempool_count == shorttxids.size())
+                break;
         }
-        // Though ideally we'd continue scanning for the two-txn-match-shortid case,
-        // the performance win of an early exit here is too good to pass up and worth
-        // the extra risk.
-        if (mempool_count == shorttxids.size())
-            break;
     }
     }
 
@@ -203,8 +230,10 @@ ReadStatus PartiallyDownloadedBlock::FillBlock(CBlock& block, const std::vector<
         return READ_STATUS_INVALID;
 
     BlockValidationState state;
-    CheckBlockFn check_block = m_check_block_mock ? m_check_block_mock : CheckBlock;
-    if (!check_block(block, state, Params().GetConsensus(), /*fCheckPoW=*/true, /*fCheckMerkleRoot=*/true)) {
+    const bool checked = m_check_block_mock ?
+        m_check_block_mock(block, state, Params().GetConsensus(), /*fCheckPoW=*/true, /*fCheckMerkleRoot=*/true) :
+        CheckBlock(block, state, Params().GetConsensus(), /*fCheckPoW=*/true, /*fCheckMerkleRoot=*/true, m_check_queue);
+    if (!checked) {
         // TODO: We really want to just check merkle tree manually here,
         // but that is expensive, and CheckBlock caches a block's
         // "checked-status" (in the CBlock?). CBlock should be able to
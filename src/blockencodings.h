@@ -11,6 +11,9 @@
 
 class CTxMemPool;
 class BlockValidationState;
+class CBlockTxCheck;
+template <typename T>
+class CCheckQueue;
 namespace Consensus {
 struct Params;
 };
@@ -112,6 +115,8 @@ public:
     CBlockHeaderAndShortTxIDs(const CBlock& block);
 
     uint64_t GetShortID(const uint256& txhash) const;
+    /** Compute out[i] = GetShortID(txhashes[i]) for all i. */
+    void GetShortIDs(Span<const uint256> txhashes, uint64_t* out) const;
 
     size_t BlockTxCount() const { return shorttxids.size() + prefilledtxn.size(); }
 
@@ -132,6 +137,8 @@ protected:
     std::vector<CTransactionRef> txn_available;
     size_t prefilled_count = 0, mempool_count = 0, extra_count = 0;
     const CTxMemPool* pool;
+    //! Queue to run the transaction checks of the reconstructed block on, if any
+    CCheckQueue<CBlockTxCheck>* m_check_queue;
 public:
     CBlockHeader header;
 
@@ -139,7 +146,7 @@ public:
     using CheckBlockFn = std::function<bool(const CBlock&, BlockValidationState&, const Consensus::Params&, bool, bool)>;
     CheckBlockFn m_check_block_mock{nullptr};
 
-    explicit PartiallyDownloadedBlock(CTxMemPool* poolIn) : pool(poolIn) {}
+    explicit PartiallyDownloadedBlock(CTxMemPool* poolIn, CCheckQueue<CBlockTxCheck>* check_queue = nullptr) : pool(poolIn), m_check_queue(check_queue) {}
 
     // extra_txn is a list of extra transactions to look at, in <witness hash, reference> form
     ReadStatus InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<std::pair<uint256, CTransactionRef>>& extra_txn);
@@ -2,6 +2,8 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <algorithm>
+#include <bit>
 #include <mutex>
 #include <set>
 
@@ -59,11 +61,11 @@ GCSFilter::GCSFilter(const Params& params, std::vector<unsigned char> encoded_fi
 
     // Verify that the encoded filter contains exactly N elements. If it has too much or too little
     // data, a std::ios_base::failure exception will be raised.
-    BitStreamReader bitreader{stream};
+    GolombRiceReader reader{Span{m_encoded}.last(stream.size())};
     for (uint64_t i = 0; i < m_N; ++i) {
-        GolombRiceDecode(bitreader, m_params.m_P);
+        reader.Decode(m_params.m_P);
     }
-    if (!stream.empty()) {
+    if (reader.BytesRead() != stream.size()) {
         throw std::ios_base::failure("encoded_filter contains excess data");
     }
 }
@@ -98,7 +100,7 @@ GCSFilter::GCSFilter(const Params& params, const ElementSet& elements)
     bitwriter.Flush();
 }
 
-bool GCSFilter::MatchInternal(const uint64_t* element_hashes, size_t size) const
+GolombRiceReader GCSFilter::GetReader() const
 {
     SpanReader stream{m_encoded};
 
@@ -106,12 +108,17 @@ bool GCSFilter::MatchInternal(const uint64_t* element_hashes, size_t size) const
     uint64_t N = ReadCompactSize(stream);
     assert(N == m_N);
 
-    BitStreamReader bitreader{stream};
+    return GolombRiceReader{Span{m_encoded}.last(stream.size())};
+}
+
+bool GCSFilter::MatchInternal(const uint64_t* element_hashes, size_t size) const
+{
+    GolombRiceReader reader{GetReader()};
 
     uint64_t value = 0;
     size_t hashes_index = 0;
     for (uint32_t i = 0; i < m_N; ++i) {
-        uint64_t delta = GolombRiceDecode(bitreader, m_params.m_P);
+        uint64_t delta = reader.Decode(m_params.m_P);
         value += delta;
 
         while (true) {
@@ -136,10 +143,59 @@ bool GCSFilter::Match(const Element& element) const
     return MatchInternal(&query, 1);
 }
 
+bool GCSFilter::MatchAnyInternal(const ElementSet& elements, std::vector<uint64_t>& buffer) const
+{
+    buffer.clear();
+    if (elements.size() <= m_N) {
+        // Merge the sorted hashes of the elements with the filter.
+        for (const Element& element : elements) {
+            buffer.push_back(HashToRange(element));
+        }
+        std::sort(buffer.begin(), buffer.end());
+        return MatchInternal(buffer.data(), buffer.size());
+    }
+
+    // With more elements than the filter has, decode the (sorted) filter and look
+    // up the hash of each element in it, which saves sorting the hashes and stops
+    // hashing at the first match. A bitmap with at least 64 bits per filter value,
+    // indexed by the low bits of the values, rules out most elements without a search.
+    const size_t bitmap_words{std::bit_ceil(size_t{m_N})};
+    buffer.resize(m_N + bitmap_words);
+    const Span<uint64_t> values{Span{buffer}.first(m_N)};
+    const Span<uint64_t> bitmap{Span{buffer}.last(bitmap_words)};
+    std::fill(bitmap.begin(), bitmap.end(), 0);
+    GolombRiceReader reader{GetReader()};
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < m_N; ++i) {
+        value += reader.Decode(m_params.m_P);
+        values[i] = value;
+        const uint64_t bit{value & (bitmap_words * 64 - 1)};
+        bitmap[bit / 64] |= uint64_t{1} << (bit % 64);
+    }
+    for (const Element& element : elements) {
+        const uint64_t hash{HashToRange(element)};
+        const uint64_t bit{hash & (bitmap_words * 64 - 1)};
+        if (!((bitmap[bit / 64] >> (bit % 64)) & 1)) continue;
+        if (std::binary_search(values.begin(), values.end(), hash)) return true;
+    }
+    return false;
+}
+
 bool GCSFilter::MatchAny(const ElementSet& elements) const
 {
-    const std::vector<uint64_t> queries = BuildHashedSet(elements);
-    return MatchInternal(queries.data(), queries.size());
+    std::vector<uint64_t> buffer;
+    return MatchAnyInternal(elements, buffer);
+}
+
+std::vector<bool> GCSFilter::MatchAnyMany(Span<const GCSFilter* const> filters, const ElementSet& elements)
+{
+    std::vector<bool> matches;
+    matches.reserve(filters.size());
+    std::vector<uint64_t> buffer;
+    for (const GCSFilter* filter : filters) {
+        matches.push_back(filter->MatchAnyInternal(elements, buffer));
+    }
+    return matches;
 }
 
 const std::string& BlockFilterTypeName(BlockFilterType filter_type)
@@ -15,11 +15,13 @@
 #include <vector>
 
 #include <attributes.h>
+#include <span.h>
 #include <uint256.h>
 #include <util/bytevectorhash.h>
 
 class CBlock;
 class CBlockUndo;
+class GolombRiceReader;
 
 /**
  * This implements a Golomb-coded set as defined in BIP 158. It is a
@@ -54,9 +56,15 @@ private:
 
     std::vector<uint64_t> BuildHashedSet(const ElementSet& elements) const;
 
+    /** Reader positioned at the first encoded element. */
+    GolombRiceReader GetReader() const;
+
     /** Helper method used to implement Match and MatchAny */
     bool MatchInternal(const uint64_t* sorted_element_hashes, size_t size) const;
 
+    /** Helper method used to implement MatchAny and MatchAnyMany, with a reusable buffer */
+    bool MatchAnyInternal(const ElementSet& elements, std::vector<uint64_t>& buffer) const;
+
 public:
 
     /** Constructs an empty filter. */
@@ -84,6 +92,12 @@ public:
      * efficient that checking Match on multiple elements separately.
      */
     bool MatchAny(const ElementSet& elements) const;
+
+    /**
+     * Checks MatchAny(elements) for each of the given filters, e.g. those of
+     * consecutive blocks during a rescan, reusing buffers between them.
+     */
+    static std::vector<bool> MatchAnyMany(Span<const GCSFilter* const> filters, const ElementSet& elements);
 };
 
 constexpr uint8_t BASIC_FILTER_P = 19;
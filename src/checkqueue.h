@@ -10,7 +10,11 @@
 #include <util/threadnames.h>
 
 #include <algorithm>
+#include <atomic>
+#include <deque>
 #include <iterator>
+#include <memory>
+#include <string>
 #include <vector>
 
 /**
@@ -22,12 +26,26 @@
   * onto the queue, where they are processed by N-1 worker threads. When
   * the master is done adding work, it temporarily joins the worker pool
   * as an N'th worker, until all jobs are done.
+  *
+  * Every thread has a deque of its own, guarded by its own mutex, so threads
+  * only contend when one of them runs out of work and steals half of another
+  * thread's deque. Added batches are spread over the worker deques. Once a
+  * verification fails, the remaining ones are dropped without running them.
   */
 template <typename T>
 class CCheckQueue
 {
 private:
-    //! Mutex to protect the inner state
+    //! The verifications a thread takes its work from.
+    struct WorkDeque {
+        Mutex m_mutex;
+        std::deque<T> m_checks GUARDED_BY(m_mutex);
+    };
+
+    //! One deque per worker thread, and a last one for the master.
+    std::vector<std::unique_ptr<WorkDeque>> m_deques;
+
+    //! Mutex for threads to sleep on. The work itself is not protected by it.
     Mutex m_mutex;
 
     //! Worker threads block on this when out of work
@@ -36,25 +54,21 @@ private:
     //! Master thread blocks on this when out of work
     std::condition_variable m_master_cv;
 
-    //! The queue of elements to be processed.
-    //! As the order of booleans doesn't matter, it is used as a LIFO (stack)
-    std::vector<T> queue GUARDED_BY(m_mutex);
-
-    //! The number of workers (including the master) that are idle.
-    int nIdle GUARDED_BY(m_mutex){0};
-
-    //! The total number of workers (including the master).
-    int nTotal GUARDED_BY(m_mutex){0};
-
-    //! The temporary evaluation result.
-    bool fAllOk GUARDED_BY(m_mutex){true};
+    //! The number of verifications in the deques, not taken by any thread yet.
+    std::atomic<size_t> m_queued{0};
 
     /**
      * Number of verifications that haven't completed yet.
      * This includes elements that are no longer queued, but still in the
      * worker's own batches.
      */
-    unsigned int nTodo GUARDED_BY(m_mutex){0};
+    std::atomic<size_t> m_todo{0};
+
+    //! The temporary evaluation result. Once false, verifications are skipped.
+    std::atomic<bool> m_all_ok{true};
+
+    //! Counter to spread added batches over the worker deques.
+    std::atomic<size_t> m_next_deque{0};
 
     //! The maximum number of elements to be processed in one batch
     const unsigned int nBatchSize;
@@ -62,64 +76,100 @@ private:
     std::vector<std::thread> m_worker_threads;
     bool m_request_stop GUARDED_BY(m_mutex){false};
 
+    //! Wake up to `count` threads after changing the counters they wait on.
+    void Notify(std::condition_variable& cond, size_t count) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        // The counters are not guarded by m_mutex. Taking it ensures that a
+        // thread that has just found nothing to do is waiting before it is
+        // notified, so the notification can't get lost.
+        { LOCK(m_mutex); }
+        if (count >= m_worker_threads.size()) {
+            cond.notify_all();
+        } else {
+            for (size_t i{0}; i < count; ++i) cond.notify_one();
+        }
+    }
+
+    //! Take a batch of verifications from the back of a thread's own deque.
+    bool TakeOwn(size_t self, std::vector<T>& checks)
+    {
+        WorkDeque& deque{*m_deques[self]};
+        LOCK(deque.m_mutex);
+        if (deque.m_checks.empty()) return false;
+        // Leave half of the deque for others to steal.
+        const size_t n{std::clamp<size_t>(deque.m_checks.size() / 2, 1, nBatchSize)};
+        const auto start_it{deque.m_checks.end() - n};
+        checks.assign(std::make_move_iterator(start_it), std::make_move_iterator(deque.m_checks.end()));
+        deque.m_checks.erase(start_it, deque.m_checks.end());
+        m_queued.fetch_sub(n, std::memory_order_relaxed);
+        return true;
+    }
+
+    //! Steal half of the front of another thread's deque. Verifications that
+    //! do not fit in one batch go to the thread's own deque.
+    bool Steal(size_t self, std::vector<T>& checks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        for (size_t i{1}; i < m_deques.size(); ++i) {
+            WorkDeque& victim{*m_deques[(self + i) % m_deques.size()]};
+            std::vector<T> stolen;
+            {
+                LOCK(victim.m_mutex);
+                if (victim.m_checks.empty()) continue;
+                const auto end_it{victim.m_checks.begin() + (victim.m_checks.size() + 1) / 2};
+                stolen.assign(std::make_move_iterator(victim.m_checks.begin()), std::make_move_iterator(end_it));
+                victim.m_checks.erase(victim.m_checks.begin(), end_it);
+            }
+            const size_t n{std::min<size_t>(stolen.size(), nBatchSize)};
+            checks.assign(std::make_move_iterator(stolen.end() - n), std::make_move_iterator(stolen.end()));
+            m_queued.fetch_sub(n, std::memory_order_relaxed);
+            if (stolen.size() > n) {
+                {
+                    WorkDeque& deque{*m_deques[self]};
+                    LOCK(deque.m_mutex);
+                    deque.m_checks.insert(deque.m_checks.end(), std::make_move_iterator(stolen.begin()), std::make_move_iterator(stolen.end() - n));
+                }
+                // Let idle threads steal the rest in turn.
+                Notify(m_worker_cv, /*count=*/stolen.size() - n);
+                Notify(m_master_cv, /*count=*/1);
+            }
+            return true;
+        }
+        return false;
+    }
+
     /** Internal function that does bulk of the verification work. */
-    bool Loop(bool fMaster) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    bool Loop(size_t self, bool fMaster) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
-        std::condition_variable& cond = fMaster ? m_master_cv : m_worker_cv;
         std::vector<T> vChecks;
         vChecks.reserve(nBatchSize);
-        unsigned int nNow = 0;
-        bool fOk = true;
-        do {
-            {
-                WAIT_LOCK(m_mutex, lock);
-                // first do the clean-up of the previous loop run (allowing us to do it in the same critsect)
-                if (nNow) {
-                    fAllOk &= fOk;
-                    nTodo -= nNow;
-                    if (nTodo == 0 && !fMaster)
-                        // We processed the last element; inform the master it can exit and return the result
-                        m_master_cv.notify_one();
-                } else {
-                    // first iteration
-                    nTotal++;
-                }
-                // logically, the do loop starts here
-                while (queue.empty() && !m_request_stop) {
-                    if (fMaster && nTodo == 0) {
-                        nTotal--;
-                        bool fRet = fAllOk;
-                        // reset the status for new work later
-                        fAllOk = true;
-                        // return the current status
-                        return fRet;
-                    }
-                    nIdle++;
-                    cond.wait(lock); // wait
-                    nIdle--;
+        while (true) {
+            if (TakeOwn(self, vChecks) || Steal(self, vChecks)) {
+                const size_t nNow{vChecks.size()};
+                // execute work
+                for (T& check : vChecks) {
+                    if (!m_all_ok.load(std::memory_order_relaxed)) break;
+                    if (!check()) m_all_ok.store(false, std::memory_order_relaxed);
                 }
-                if (m_request_stop) {
-                    return false;
+                vChecks.clear();
+                if (m_todo.fetch_sub(nNow, std::memory_order_acq_rel) == nNow) {
+                    // We processed the last element; inform the master it can exit and return the result
+                    Notify(m_master_cv, /*count=*/1);
                 }
+                continue;
+            }
 
-                // Decide how many work units to process now.
-                // * Do not try to do everything at once, but aim for increasingly smaller batches so
-                //   all workers finish approximately simultaneously.
-                // * Try to account for idle jobs which will instantly start helping.
-                // * Don't do batches smaller than 1 (duh), or larger than nBatchSize.
-                nNow = std::max(1U, std::min(nBatchSize, (unsigned int)queue.size() / (nTotal + nIdle + 1)));
-                auto start_it = queue.end() - nNow;
-                vChecks.assign(std::make_move_iterator(start_it), std::make_move_iterator(queue.end()));
-                queue.erase(start_it, queue.end());
-                // Check whether we need to do work at all
-                fOk = fAllOk;
+            WAIT_LOCK(m_mutex, lock);
+            if (fMaster) {
+                m_master_cv.wait(lock, [&] { return m_todo.load(std::memory_order_acquire) == 0 || m_queued.load(std::memory_order_relaxed) > 0; });
+                if (m_todo.load(std::memory_order_acquire) == 0) {
+                    // return the current status, and reset it for new work later
+                    return m_all_ok.exchange(true, std::memory_order_relaxed);
+                }
+            } else {
+                m_worker_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_request_stop || m_queued.load(std::memory_order_relaxed) > 0; });
+                if (m_request_stop) return false;
             }
-            // execute work
-            for (T& check : vChecks)
-                if (fOk)
-                    fOk = check();
-            vChecks.clear();
-        } while (true);
+        }
     }
 
 public:
@@ -127,14 +177,17 @@ public:
     Mutex m_control_mutex;
 
     //! Create a new check queue
-    explicit CCheckQueue(unsigned int batch_size, int worker_threads_num)
-        : nBatchSize(batch_size)
+    explicit CCheckQueue(unsigned int batch_size, int worker_threads_num, const std::string& thread_name = "scriptch")
+        : nBatchSize(std::max(batch_size, 1U))
     {
+        for (int n = 0; n <= worker_threads_num; ++n) {
+            m_deques.push_back(std::make_unique<WorkDeque>());
+        }
         m_worker_threads.reserve(worker_threads_num);
         for (int n = 0; n < worker_threads_num; ++n) {
-            m_worker_threads.emplace_back([this, n]() {
-                util::ThreadRename(strprintf("scriptch.%i", n));
-                Loop(false /* worker thread */);
+            m_worker_threads.emplace_back([this, n, thread_name]() {
+                util::ThreadRename(strprintf("%s.%i", thread_name, n));
+                Loop(n, false /* worker thread */);
             });
         }
     }
@@ -149,27 +202,29 @@ public:
     //! Wait until execution finishes, and return whether all evaluations were successful.
     bool Wait() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
-        return Loop(true /* master thread */);
+        return Loop(m_worker_threads.size(), true /* master thread */);
     }
 
     //! Add a batch of checks to the queue
     void Add(std::vector<T>&& vChecks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
-        if (vChecks.empty()) {
+        // After a failure the result is known, don't bother running more checks.
+        if (vChecks.empty() || !m_all_ok.load(std::memory_order_relaxed)) {
             return;
         }
 
+        const size_t n{vChecks.size()};
+        m_todo.fetch_add(n, std::memory_order_relaxed);
+        m_queued.fetch_add(n, std::memory_order_relaxed);
+        // Without worker threads, everything goes to the master's deque.
+        const size_t target{m_worker_threads.empty() ? 0 : m_next_deque.fetch_add(1, std::memory_order_relaxed) % m_worker_threads.size()};
         {
-            LOCK(m_mutex);
-            queue.insert(queue.end(), std::make_move_iterator(vChecks.begin()), std::make_move_iterator(vChecks.end()));
-            nTodo += vChecks.size();
+            WorkDeque& deque{*m_deques[target]};
+            LOCK(deque.m_mutex);
+            deque.m_checks.insert(deque.m_checks.end(), std::make_move_iterator(vChecks.begin()), std::make_move_iterator(vChecks.end()));
         }
 
-        if (vChecks.size() == 1) {
-            m_worker_cv.notify_one();
-        } else {
-            m_worker_cv.notify_all();
-        }
+        Notify(m_worker_cv, /*count=*/n);
     }
 
     ~CCheckQueue()
@@ -0,0 +1,184 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_CLUSTER_LINEARIZE_H
+#define BITCOIN_CLUSTER_LINEARIZE_H
+
+#include <consensus/amount.h>
+#include <span.h>
+#include <util/check.h>
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * Linearization of clusters: groups of mempool transactions that are connected
+ * by spending relations. A linearization is a topological order of a cluster
+ * in which the transactions are best mined. Splitting it into chunks, runs of
+ * transactions that are mined together, gives the feerates at which the
+ * cluster competes for block space, and at which it should be evicted.
+ */
+namespace cluster_linearize {
+
+/** Fee and size of a transaction or a set of transactions. */
+struct FeeFrac {
+    CAmount fee{0};
+    int64_t size{0};
+
+    FeeFrac() = default;
+    FeeFrac(CAmount fee_in, int64_t size_in) : fee{fee_in}, size{size_in} {}
+
+    FeeFrac& operator+=(const FeeFrac& other)
+    {
+        fee += other.fee;
+        size += other.size;
+        return *this;
+    }
+
+    FeeFrac& operator-=(const FeeFrac& other)
+    {
+        fee -= other.fee;
+        size -= other.size;
+        return *this;
+    }
+
+    //! Whether this has a strictly higher feerate than other.
+    bool HigherFeerateThan(const FeeFrac& other) const
+    {
+        // Avoid division by rewriting (a/b > c/d) as (a*d > c*b). The products are
+        // computed exactly, as 128-bit numbers.
+        return Mul(fee, other.size) > Mul(other.fee, size);
+    }
+
+private:
+    /** Exact product of a fee and a size. */
+#ifdef __SIZEOF_INT128__
+    static __int128 Mul(int64_t a, int64_t b)
+    {
+        return __int128{a} * b;
+    }
+#else
+    static std::pair<int64_t, uint32_t> Mul(int64_t a, int64_t b)
+    {
+        // Split a into its (signed) upper and (unsigned) lower 32 bits, and multiply
+        // them separately. This requires b to fit in 31 bits, which holds for the
+        // size of any set of transactions.
+        Assume(b >= 0 && b <= std::numeric_limits<int32_t>::max());
+        const int64_t low{int64_t{static_cast<uint32_t>(a)} * b};
+        const int64_t high{(a >> 32) * b};
+        return {high + (low >> 32), static_cast<uint32_t>(low)};
+    }
+#endif
+};
+
+/** A chunk of a linearization: its combined fee and size, and the number of transactions in it. */
+using Chunk = std::pair<FeeFrac, uint32_t>;
+
+/**
+ * Linearize a cluster, by repeatedly picking the remaining transaction whose
+ * remaining ancestors (including itself) have the highest combined feerate,
+ * and appending those ancestors in topological order. This is how
+ * BlockAssembler selects packages, so the result is never worse than mining
+ * by ancestor feerate. It is not always optimal, but runs in O(n^2) time.
+ *
+ * @param[in] feerates  Fee and size of every transaction of the cluster.
+ * @param[in] parents   For every transaction, the indices of its parents in the cluster.
+ * @returns The indices of all transactions, in linearization order.
+ */
+inline std::vector<uint32_t> Linearize(Span<const FeeFrac> feerates, Span<const std::vector<uint32_t>> parents)
+{
+    const size_t n{feerates.size()};
+    Assume(parents.size() == n);
+    const size_t words{(n + 63) / 64};
+
+    // Order the transactions topologically, so that ancestors can be appended in order.
+    std::vector<uint32_t> topo_order;
+    topo_order.reserve(n);
+    {
+        std::vector<std::vector<uint32_t>> children(n);
+        std::vector<size_t> missing_parents(n);
+        for (uint32_t i{0}; i < n; ++i) {
+            missing_parents[i] = parents[i].size();
+            for (uint32_t parent : parents[i]) children[parent].push_back(i);
+            if (missing_parents[i] == 0) topo_order.push_back(i);
+        }
+        for (size_t next{0}; next < topo_order.size(); ++next) {
+            for (uint32_t child : children[topo_order[next]]) {
+                if (--missing_parents[child] == 0) topo_order.push_back(child);
+            }
+        }
+        // A cycle would leave transactions out.
+        Assume(topo_order.size() == n);
+    }
+
+    // Ancestor sets (including the transaction itself) as bitsets, and their feerates.
+    std::vector<uint64_t> ancestors(n * words);
+    const auto anc{[&](uint32_t i) { return Span{ancestors}.subspan(i * words, words); }};
+    std::vector<FeeFrac> anc_feerates(n);
+    for (uint32_t i : topo_order) {
+        anc(i)[i / 64] |= uint64_t{1} << (i % 64);
+        for (uint32_t parent : parents[i]) {
+            for (size_t w{0}; w < words; ++w) anc(i)[w] |= anc(parent)[w];
+        }
+        for (size_t w{0}; w < words; ++w) {
+            for (uint64_t bits{anc(i)[w]}; bits; bits &= bits - 1) {
+                anc_feerates[i] += feerates[w * 64 + std::countr_zero(bits)];
+            }
+        }
+    }
+
+    std::vector<uint32_t> linearization;
+    linearization.reserve(n);
+    std::vector<uint64_t> done(words);
+    const auto is_done{[&](uint32_t i) { return (done[i / 64] >> (i % 64)) & 1; }};
+    std::vector<uint64_t> picked(words);
+    while (linearization.size() < n) {
+        std::optional<uint32_t> best;
+        for (uint32_t i{0}; i < n; ++i) {
+            if (!is_done(i) && (!best || anc_feerates[i].HigherFeerateThan(anc_feerates[*best]))) best = i;
+        }
+        for (size_t w{0}; w < words; ++w) picked[w] = anc(*best)[w] & ~done[w];
+        for (uint32_t i : topo_order) {
+            if ((picked[i / 64] >> (i % 64)) & 1) linearization.push_back(i);
+        }
+        for (size_t w{0}; w < words; ++w) done[w] |= picked[w];
+        // The picked transactions are no longer part of the remaining ancestors of anything.
+        for (uint32_t i{0}; i < n; ++i) {
+            if (is_done(i)) continue;
+            for (size_t w{0}; w < words; ++w) {
+                for (uint64_t bits{anc(i)[w] & picked[w]}; bits; bits &= bits - 1) {
+                    anc_feerates[i] -= feerates[w * 64 + std::countr_zero(bits)];
+                }
+            }
+        }
+    }
+    return linearization;
+}
+
+/**
+ * Split a linearization into chunks, by merging every transaction into the
+ * chunk before it for as long as that chunk does not have a higher feerate.
+ * The resulting chunk feerates are decreasing.
+ */
+inline std::vector<Chunk> ChunkLinearization(Span<const FeeFrac> feerates, Span<const uint32_t> linearization)
+{
+    std::vector<Chunk> chunks;
+    for (uint32_t i : linearization) {
+        chunks.emplace_back(feerates[i], 1);
+        while (chunks.size() >= 2 && !chunks[chunks.size() - 2].first.HigherFeerateThan(chunks.back().first)) {
+            chunks[chunks.size() - 2].first += chunks.back().first;
+            chunks[chunks.size() - 2].second += chunks.back().second;
+            chunks.pop_back();
+        }
+    }
+    return chunks;
+}
+
+} // namespace cluster_linearize
+
+#endif // BITCOIN_CLUSTER_LINEARIZE_H
@@ -8,10 +8,10 @@
 
 #include <compressor.h>
 #include <core_memusage.h>
+#include <flathashmap.h>
 #include <memusage.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
-#include <support/allocators/pool.h>
 #include <uint256.h>
 #include <util/hasher.h>
 
@@ -19,7 +19,6 @@
 #include <stdint.h>
 
 #include <functional>
-#include <unordered_map>
 
 /**
  * A UTXO entry.
@@ -133,21 +132,12 @@ struct CCoinsCacheEntry
 };
 
 /**
- * PoolAllocator's MAX_BLOCK_SIZE_BYTES parameter here uses sizeof the data, and adds the size
- * of 4 pointers. We do not know the exact node size used in the std::unordered_node implementation
- * because it is implementation defined. Most implementations have an overhead of 1 or 2 pointers,
- * so nodes can be connected in a linked list, and in some cases the hash value is stored as well.
- * Using an additional sizeof(void*)*4 for MAX_BLOCK_SIZE_BYTES should thus be sufficient so that
- * all implementations can allocate the nodes from the PoolAllocator.
+ * The coins cache is a flat, open-addressing hash map: entries are stored
+ * inline in one slot array, so a lookup touches fewer cache lines than with
+ * a node-based map, and no per-coin node is allocated. Note that inserting into a CCoinsMap invalidates all iterators
+ * and references into it, see FlatHashMap.
  */
-using CCoinsMap = std::unordered_map<COutPoint,
-                                     CCoinsCacheEntry,
-                                     SaltedOutpointHasher,
-                                     std::equal_to<COutPoint>,
-                                     PoolAllocator<std::pair<const COutPoint, CCoinsCacheEntry>,
-                                                   sizeof(std::pair<const COutPoint, CCoinsCacheEntry>) + sizeof(void*) * 4>>;
-
-using CCoinsMapMemoryResource = CCoinsMap::allocator_type::ResourceType;
+using CCoinsMap = FlatHashMap<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher>;
 
 /** Cursor for iterating over CoinsView state */
 class CCoinsViewCursor
@@ -197,6 +187,12 @@ public:
     //! Get a cursor to iterate over the whole state
     virtual std::unique_ptr<CCoinsViewCursor> Cursor() const;
 
+    //! Get up to num_ranges cursors over consecutive, disjoint key ranges that
+    //! together iterate over the whole state, so that it can be scanned by
+    //! several threads. All cursors see the same state. Returns an empty vector
+    //! if iteration is not supported.
+    virtual std::vector<std::unique_ptr<CCoinsViewCursor>> RangeCursors(size_t num_ranges) const;
+
     //! As we use CCoinsViews polymorphically, have a virtual destructor
     virtual ~CCoinsView() {}
 
@@ -220,6 +216,7 @@ public:
     void SetBackend(CCoinsView &viewIn);
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock, bool erase = true) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> RangeCursors(size_t num_ranges) const override;
     size_t EstimateSize() const override;
 };
 
@@ -236,8 +233,9 @@ protected:
      * declared as "const".
      */
     mutable uint256 hashBlock;
-    mutable CCoinsMapMemoryResource m_cache_coins_memory_resource{};
     mutable CCoinsMap cacheCoins;
+    //! Number of map slots whose table alone fits into the memory budget, see SetMemoryBudget().
+    size_t m_map_capacity_limit{SIZE_MAX};
 
     /* Cached dynamic memory usage for the inner Coin objects. */
     mutable size_t cachedCoinsUsage{0};
@@ -259,6 +257,9 @@ public:
     std::unique_ptr<CCoinsViewCursor> Cursor() const override {
         throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
     }
+    std::vector<std::unique_ptr<CCoinsViewCursor>> RangeCursors(size_t num_ranges) const override {
+        throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
+    }
 
     /**
      * Check if we have the given utxo already loaded in this cache.
@@ -272,10 +273,9 @@ public:
      * more efficient than GetCoin.
      *
      * Generally, do not hold the reference returned for more than a short scope.
-     * While the current implementation allows for modifications to the contents
-     * of the cache while holding the reference, this behavior should not be relied
-     * on! To be safe, best to not hold the returned reference through any other
-     * calls to this cache.
+     * Any call that may add a coin to this cache (including other lookups that
+     * miss and fetch from the backing view) can move the cached coins and
+     * invalidate the returned reference.
      */
     const Coin& AccessCoin(const COutPoint &output) const;
 
@@ -294,6 +294,13 @@ public:
      */
     void EmplaceCoinInternalDANGER(COutPoint&& outpoint, Coin&& coin);
 
+    /**
+     * Add an unspent coin that was read from the base view elsewhere, e.g.
+     * prefetched in parallel, as if FetchCoin() had fetched it. The coin is not
+     * marked DIRTY, and nothing happens if the outpoint is already cached.
+     */
+    void AddFetchedCoin(const COutPoint& outpoint, Coin&& coin);
+
     /**
      * Spend a coin. Pass moveto in order to get the deleted data.
      * If no unspent output exists for the passed outpoint, this call
@@ -333,11 +340,15 @@ public:
     //! Check whether all prevouts of the transaction are present in the UTXO set represented by this view
     bool HaveInputs(const CTransaction& tx) const;
 
+    //! Tell the cache how much memory it may use before it gets flushed, so
+    //! that growing the map does not overshoot the budget by doubling its table.
+    //! This is only a cap on the number of slots of the table (the budget
+    //! divided by the slot size); it does not account for the dynamic memory of
+    //! the coins, see DynamicMemoryUsage().
+    void SetMemoryBudget(size_t max_bytes);
+
     //! Force a reallocation of the cache map. This is required when downsizing
-    //! the cache because the map's allocator may be hanging onto a lot of
-    //! memory despite having called .clear().
-    //!
-    //! See: https://stackoverflow.com/questions/42114044/how-to-release-unordered-map-memory
+    //! the cache because the map never shrinks its table, even after .clear().
     void ReallocateCache();
 
     //! Run an internal sanity check on the cache data structure. */
@@ -5,6 +5,10 @@
 // Based on the public domain implementation 'merged' by D. J. Bernstein
 // See https://cr.yp.to/chacha.html.
 
+#if defined(HAVE_CONFIG_H)
+#include <config/bitcoin-config.h>
+#endif
+
 #include <crypto/common.h>
 #include <crypto/chacha20.h>
 #include <support/cleanse.h>
@@ -14,6 +18,20 @@
 #include <bit>
 #include <string.h>
 
+#if (defined(__SSE2__) || defined(__ARM_NEON)) && !defined(WORDS_BIGENDIAN)
+#define CHACHA20_VEC_4WAY
+#include <crypto/chacha20_vec.ipp>
+#endif
+
+#if !defined(DISABLE_OPTIMIZED_CHACHA20) && defined(ENABLE_AVX2) && defined(USE_ASM) && defined(HAVE_GETCPUID)
+#define CHACHA20_AVX2_8WAY
+#include <compat/cpuid.h>
+
+namespace chacha20_avx2 {
+size_t Crypt_8way(const uint32_t input[12], unsigned char* c, const unsigned char* m, size_t blocks);
+}
+#endif
+
 #define QUARTERROUND(a,b,c,d) \
   a += b; d = std::rotl(d ^ a, 16); \
   c += d; b = std::rotl(b ^ c, 12); \
@@ -22,6 +40,52 @@
 
 #define REPEAT10(a) do { {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; } while(0)
 
+namespace {
+
+#if defined(CHACHA20_AVX2_8WAY)
+/** Check whether the CPU supports AVX2, and the OS has enabled AVX registers. */
+bool HaveAVX2()
+{
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    if (!have_xsave || !have_avx) return false;
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    if ((a & 6) != 6) return false;
+    GetCPUID(7, 0, eax, ebx, ecx, edx);
+    return (ebx >> 5) & 1;
+}
+#endif
+
+/** Process the leading blocks of a Keystream/Crypt call with the widest available multi-block
+ *  implementation, and advance the block counter in input accordingly. The remaining blocks
+ *  (fewer than the narrowest implementation's width) are left to the scalar code. Returns the
+ *  number of blocks processed. */
+size_t CryptMultiBlock(uint32_t input[12], unsigned char* c, const unsigned char* m, size_t blocks)
+{
+    size_t done = 0;
+    [[maybe_unused]] const auto advance{[&](size_t processed) {
+        const uint32_t counter = input[8] + uint32_t(processed);
+        if (counter < input[8]) ++input[9];
+        input[8] = counter;
+        done += processed;
+    }};
+#if defined(CHACHA20_AVX2_8WAY)
+    static const bool have_avx2{HaveAVX2()};
+    if (have_avx2) {
+        advance(chacha20_avx2::Crypt_8way(input, c, m, blocks));
+    }
+#endif
+#if defined(CHACHA20_VEC_4WAY)
+    advance(ChaCha20MultiBlock<vec128>(input, c + done * 64, m ? m + done * 64 : nullptr, blocks - done));
+#endif
+    return done;
+}
+
+} // namespace
+
 void ChaCha20Aligned::SetKey(Span<const std::byte> key) noexcept
 {
     assert(key.size() == KEYLEN);
@@ -63,6 +127,10 @@ inline void ChaCha20Aligned::Keystream(Span<std::byte> output) noexcept
     size_t blocks = output.size() / BLOCKLEN;
     assert(blocks * BLOCKLEN == output.size());
 
+    const size_t done = CryptMultiBlock(input, c, nullptr, blocks);
+    blocks -= done;
+    c += done * BLOCKLEN;
+
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
     uint32_t j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
 
@@ -166,6 +234,11 @@ inline void ChaCha20Aligned::Crypt(Span<const std::byte> in_bytes, Span<std::byt
     size_t blocks = out_bytes.size() / BLOCKLEN;
     assert(blocks * BLOCKLEN == out_bytes.size());
 
+    const size_t done = CryptMultiBlock(input, c, m, blocks);
+    blocks -= done;
+    c += done * BLOCKLEN;
+    m += done * BLOCKLEN;
+
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
     uint32_t j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
 
@@ -0,0 +1,21 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <crypto/chacha20_vec.ipp>
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace chacha20_avx2 {
+
+size_t Crypt_8way(const uint32_t input[12], unsigned char* c, const unsigned char* m, size_t blocks)
+{
+    return ChaCha20MultiBlock<vec256>(input, c, m, blocks);
+}
+
+} // namespace chacha20_avx2
+
+#endif
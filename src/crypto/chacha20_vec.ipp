@@ -0,0 +1,157 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Multi-block ChaCha20 using compiler vector extensions. This file is included
+// by translation units compiled with different target flags (e.g. AVX2), so
+// everything in it must have internal linkage.
+
+#ifndef BITCOIN_CRYPTO_CHACHA20_VEC_IPP
+#define BITCOIN_CRYPTO_CHACHA20_VEC_IPP
+
+#include <attributes.h>
+
+#include <cstddef>
+#include <cstring>
+#include <stdint.h>
+
+namespace {
+
+/** 4 lanes of 32 bits (SSE2 / NEON registers). */
+using vec128 = uint32_t __attribute__((vector_size(16)));
+/** 8 lanes of 32 bits (AVX2 registers). */
+using vec256 = uint32_t __attribute__((vector_size(32)));
+
+#if defined(__clang__)
+#define CHACHA20_SHUFFLE(V, a, b, ...) __builtin_shufflevector(a, b, __VA_ARGS__)
+#else
+#define CHACHA20_SHUFFLE(V, a, b, ...) __builtin_shuffle(a, b, V{__VA_ARGS__})
+#endif
+
+template <int N, typename V>
+ALWAYS_INLINE V Rotl(V x) { return (x << N) | (x >> (32 - N)); }
+
+template <typename V>
+ALWAYS_INLINE void QuarterRound(V& a, V& b, V& c, V& d)
+{
+    a += b; d = Rotl<16>(d ^ a);
+    c += d; b = Rotl<12>(b ^ c);
+    a += b; d = Rotl<8>(d ^ a);
+    c += d; b = Rotl<7>(b ^ c);
+}
+
+/** Transpose 4x4 blocks of words: afterwards, the 128-bit half h of a (resp. b, c, d) holds
+ *  the 4 input words of lane 4 * h (resp. 4 * h + 1, ...). */
+ALWAYS_INLINE void Transpose(vec128& a, vec128& b, vec128& c, vec128& d)
+{
+    const vec128 t0 = CHACHA20_SHUFFLE(vec128, a, b, 0, 4, 1, 5);
+    const vec128 t1 = CHACHA20_SHUFFLE(vec128, a, b, 2, 6, 3, 7);
+    const vec128 t2 = CHACHA20_SHUFFLE(vec128, c, d, 0, 4, 1, 5);
+    const vec128 t3 = CHACHA20_SHUFFLE(vec128, c, d, 2, 6, 3, 7);
+    a = CHACHA20_SHUFFLE(vec128, t0, t2, 0, 1, 4, 5);
+    b = CHACHA20_SHUFFLE(vec128, t0, t2, 2, 3, 6, 7);
+    c = CHACHA20_SHUFFLE(vec128, t1, t3, 0, 1, 4, 5);
+    d = CHACHA20_SHUFFLE(vec128, t1, t3, 2, 3, 6, 7);
+}
+
+ALWAYS_INLINE void Transpose(vec256& a, vec256& b, vec256& c, vec256& d)
+{
+    const vec256 t0 = CHACHA20_SHUFFLE(vec256, a, b, 0, 8, 1, 9, 4, 12, 5, 13);
+    const vec256 t1 = CHACHA20_SHUFFLE(vec256, a, b, 2, 10, 3, 11, 6, 14, 7, 15);
+    const vec256 t2 = CHACHA20_SHUFFLE(vec256, c, d, 0, 8, 1, 9, 4, 12, 5, 13);
+    const vec256 t3 = CHACHA20_SHUFFLE(vec256, c, d, 2, 10, 3, 11, 6, 14, 7, 15);
+    a = CHACHA20_SHUFFLE(vec256, t0, t2, 0, 1, 8, 9, 4, 5, 12, 13);
+    b = CHACHA20_SHUFFLE(vec256, t0, t2, 2, 3, 10, 11, 6, 7, 14, 15);
+    c = CHACHA20_SHUFFLE(vec256, t1, t3, 0, 1, 8, 9, 4, 5, 12, 13);
+    d = CHACHA20_SHUFFLE(vec256, t1, t3, 2, 3, 10, 11, 6, 7, 14, 15);
+}
+
+#undef CHACHA20_SHUFFLE
+
+/** Compute one ChaCha20 block per vector lane, i.e. sizeof(V) / 4 consecutive blocks
+ *  starting at the block counter in input[8], and write them (xor'ed with m, if not
+ *  nullptr) to c. The caller is responsible for advancing the block counter. */
+template <typename V>
+ALWAYS_INLINE void ChaCha20Lanes(const uint32_t input[12], unsigned char* c, const unsigned char* m)
+{
+    constexpr size_t LANES{sizeof(V) / sizeof(uint32_t)};
+
+    V j[16];
+    j[0] = V{} + 0x61707865;
+    j[1] = V{} + 0x3320646e;
+    j[2] = V{} + 0x79622d32;
+    j[3] = V{} + 0x6b206574;
+    for (int i = 0; i < 8; ++i) j[4 + i] = V{} + input[i];
+    // Every lane gets its own block counter. An overflow of the 32-bit counter carries into the
+    // first nonce word, like the scalar implementation.
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        const uint32_t counter = input[8] + uint32_t(lane);
+        j[12][lane] = counter;
+        j[13][lane] = input[9] + (counter < input[8]);
+    }
+    j[14] = V{} + input[10];
+    j[15] = V{} + input[11];
+
+    V x[16];
+    for (int i = 0; i < 16; ++i) x[i] = j[i];
+
+    for (int round = 0; round < 10; ++round) {
+        QuarterRound(x[0], x[4], x[8], x[12]);
+        QuarterRound(x[1], x[5], x[9], x[13]);
+        QuarterRound(x[2], x[6], x[10], x[14]);
+        QuarterRound(x[3], x[7], x[11], x[15]);
+        QuarterRound(x[0], x[5], x[10], x[15]);
+        QuarterRound(x[1], x[6], x[11], x[12]);
+        QuarterRound(x[2], x[7], x[8], x[13]);
+        QuarterRound(x[3], x[4], x[9], x[14]);
+    }
+
+    for (int i = 0; i < 16; ++i) x[i] += j[i];
+
+    // Lane l of x[i] is word i of block l. Transpose groups of 4 words, so that every 128-bit
+    // half of a vector holds 16 consecutive output bytes of a single block. This relies on a
+    // little-endian memory layout of the vectors.
+    for (int i = 0; i < 16; i += 4) {
+        Transpose(x[i], x[i + 1], x[i + 2], x[i + 3]);
+        for (size_t half = 0; half < LANES / 4; ++half) {
+            for (int k = 0; k < 4; ++k) {
+                vec128 out;
+                std::memcpy(&out, reinterpret_cast<const unsigned char*>(&x[i + k]) + 16 * half, 16);
+                const size_t pos = 64 * (4 * half + k) + 4 * i;
+                if (m) {
+                    vec128 in;
+                    std::memcpy(&in, m + pos, 16);
+                    out ^= in;
+                }
+                std::memcpy(c + pos, &out, 16);
+            }
+        }
+    }
+}
+
+/** Process as many whole groups of sizeof(V) / 4 blocks as fit in blocks, and return the
+ *  number of blocks processed. */
+template <typename V>
+size_t ChaCha20MultiBlock(const uint32_t input[12], unsigned char* c, const unsigned char* m, size_t blocks)
+{
+    constexpr size_t LANES{sizeof(V) / sizeof(uint32_t)};
+    uint32_t state[12];
+    for (int i = 0; i < 12; ++i) state[i] = input[i];
+    size_t done = 0;
+    while (blocks - done >= LANES) {
+        if (m) {
+            ChaCha20Lanes<V>(state, c + 64 * done, m + 64 * done);
+        } else {
+            ChaCha20Lanes<V>(state, c + 64 * done, nullptr);
+        }
+        const uint32_t counter = state[8] + uint32_t(LANES);
+        if (counter < state[8]) ++state[9];
+        state[8] = counter;
+        done += LANES;
+    }
+    return done;
+}
+
+} // namespace
+
+#endif // BITCOIN_CRYPTO_CHACHA20_VEC_IPP
@@ -13,15 +13,29 @@
 
 #define POLY1305_BLOCK_SIZE 16
 
+#if defined(__SIZEOF_INT128__)
+#define POLY1305_DONNA_64
+#endif
+
 namespace poly1305_donna {
 
 // Based on the public domain implementation by Andrew Moon
-// poly1305-donna-32.h from https://github.com/floodyberry/poly1305-donna
+// poly1305-donna-32.h and poly1305-donna-64.h from https://github.com/floodyberry/poly1305-donna
+//
+// The 64-bit version (3 limbs of 44 bits, multiplied into 128-bit products) is used on
+// platforms with a native 128-bit integer type, the 32-bit version (5 limbs of 26 bits)
+// elsewhere.
 
 typedef struct {
+#if defined(POLY1305_DONNA_64)
+    uint64_t r[3];
+    uint64_t h[3];
+    uint64_t pad[2];
+#else
     uint32_t r[5];
     uint32_t h[5];
     uint32_t pad[4];
+#endif
     size_t leftover;
     unsigned char buffer[POLY1305_BLOCK_SIZE];
     unsigned char final;
@@ -44,6 +44,21 @@ namespace sha256d64_avx2
 void Transform_8way(unsigned char* out, const unsigned char* in);
 }
 
+namespace sha256_avx2
+{
+void TransformMulti_8way(uint32_t* s, const unsigned char* const* chunks);
+}
+
+namespace sha256d64_avx512
+{
+void Transform_16way(unsigned char* out, const unsigned char* in);
+}
+
+namespace sha256_avx512
+{
+void TransformMulti_16way(uint32_t* s, const unsigned char* const* chunks);
+}
+
 namespace sha256d64_x86_shani
 {
 void Transform_2way(unsigned char* out, const unsigned char* in);
@@ -442,6 +457,9 @@ void TransformD64(unsigned char* out, const unsigned char* in)
 
 typedef void (*TransformType)(uint32_t*, const unsigned char*, size_t);
 typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
+/** Process one block for each of N independent SHA256 states at once. The state is stored
+ *  word-major: s[i * N + lane] is word i of the state of lane. */
+typedef void (*TransformMultiType)(uint32_t*, const unsigned char* const*);
 
 template<TransformType tr>
 void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
@@ -487,6 +505,9 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformD64Type TransformD64_16way = nullptr;
+TransformMultiType TransformMulti = nullptr;
+size_t TransformMultiLanes = 0;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -570,6 +591,32 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test TransformD64_16way, if available, on the 8 messages twice.
+    if (TransformD64_16way) {
+        unsigned char in[1024], out[512];
+        std::copy(data + 1, data + 513, in);
+        std::copy(data + 1, data + 513, in + 512);
+        TransformD64_16way(out, in);
+        if (!std::equal(out, out + 256, result_d64)) return false;
+        if (!std::equal(out + 256, out + 512, result_d64)) return false;
+    }
+
+    // Test TransformMulti, if available: lane i continues from the state after i % 8 blocks.
+    if (TransformMulti) {
+        uint32_t state[8 * 16];
+        const unsigned char* chunks[16];
+        for (size_t lane = 0; lane < TransformMultiLanes; ++lane) {
+            for (int i = 0; i < 8; ++i) state[i * TransformMultiLanes + lane] = result[lane % 8][i];
+            chunks[lane] = data + 1 + 64 * (lane % 8);
+        }
+        TransformMulti(state, chunks);
+        for (size_t lane = 0; lane < TransformMultiLanes; ++lane) {
+            for (int i = 0; i < 8; ++i) {
+                if (state[i * TransformMultiLanes + lane] != result[lane % 8 + 1][i]) return false;
+            }
+        }
+    }
+
     return true;
 }
 
@@ -582,6 +629,14 @@ bool AVXEnabled()
     __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
     return (a & 6) == 6;
 }
+
+/** Check whether the OS has enabled AVX-512 registers (opmask and all 32 ZMM registers). */
+bool AVX512Enabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 0xe6) == 0xe6;
+}
 #endif
 #endif // DISABLE_OPTIMIZED_SHA256
 } // namespace
@@ -595,6 +650,9 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     TransformD64_2way = nullptr;
     TransformD64_4way = nullptr;
     TransformD64_8way = nullptr;
+    TransformD64_16way = nullptr;
+    TransformMulti = nullptr;
+    TransformMultiLanes = 0;
 
 #if !defined(DISABLE_OPTIMIZED_SHA256)
 #if defined(USE_ASM) && defined(HAVE_GETCPUID)
@@ -602,8 +660,10 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     bool have_xsave = false;
     bool have_avx = false;
     [[maybe_unused]] bool have_avx2 = false;
+    [[maybe_unused]] bool have_avx512 = false;
     [[maybe_unused]] bool have_x86_shani = false;
     [[maybe_unused]] bool enabled_avx = false;
+    [[maybe_unused]] bool enabled_avx512 = false;
 
     uint32_t eax, ebx, ecx, edx;
     GetCPUID(1, 0, eax, ebx, ecx, edx);
@@ -614,12 +674,16 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     have_avx = (ecx >> 28) & 1;
     if (have_xsave && have_avx) {
         enabled_avx = AVXEnabled();
+        enabled_avx512 = AVX512Enabled();
     }
     if (have_sse4) {
         GetCPUID(7, 0, eax, ebx, ecx, edx);
         if (use_implementation & sha256_implementation::USE_AVX2) {
             have_avx2 = (ebx >> 5) & 1;
         }
+        if (use_implementation & sha256_implementation::USE_AVX512) {
+            have_avx512 = (ebx >> 16) & 1;
+        }
         if (use_implementation & sha256_implementation::USE_SHANI) {
             have_x86_shani = (ebx >> 29) & 1;
         }
@@ -633,6 +697,7 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
         ret = "x86_shani(1way,2way)";
         have_sse4 = false; // Disable SSE4/AVX2;
         have_avx2 = false;
+        // AVX-512 is still used for 16 hashes at a time, which beats SHA-NI's 2-way throughput.
     }
 #endif
 
@@ -651,9 +716,20 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
 #if defined(ENABLE_AVX2)
     if (have_avx2 && have_avx && enabled_avx) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformMulti = sha256_avx2::TransformMulti_8way;
+        TransformMultiLanes = 8;
         ret += ",avx2(8way)";
     }
 #endif
+
+#if defined(ENABLE_AVX512)
+    if (have_avx512 && have_avx && enabled_avx512) {
+        TransformD64_16way = sha256d64_avx512::Transform_16way;
+        TransformMulti = sha256_avx512::TransformMulti_16way;
+        TransformMultiLanes = 16;
+        ret += ",avx512(16way)";
+    }
+#endif
 #endif // defined(USE_ASM) && defined(HAVE_GETCPUID)
 
 #if defined(ENABLE_ARM_SHANI)
@@ -753,6 +829,14 @@ CSHA256& CSHA256::Reset()
 
 void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
 {
+    if (TransformD64_16way) {
+        while (blocks >= 16) {
+            TransformD64_16way(out, in);
+            out += 512;
+            in += 1024;
+            blocks -= 16;
+        }
+    }
     if (TransformD64_8way) {
         while (blocks >= 8) {
             TransformD64_8way(out, in);
@@ -784,3 +868,96 @@ void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
         --blocks;
     }
 }
+
+void SHA256DMany(unsigned char* out, const unsigned char* const* in, const size_t* lengths, size_t count)
+{
+    const size_t lanes = TransformMultiLanes;
+    if (!TransformMulti || count < 2) {
+        for (size_t i = 0; i < count; ++i) {
+            unsigned char buf[CSHA256::OUTPUT_SIZE];
+            CSHA256().Write(in[i], lengths[i]).Finalize(buf);
+            CSHA256().Write(buf, sizeof(buf)).Finalize(out + 32 * i);
+        }
+        return;
+    }
+
+    // Every lane walks through the full 64-byte blocks of its message, then one or two padded
+    // tail blocks, then the single block of the second hash, after which it picks up the next
+    // message. Lanes without work left hash a dummy block.
+    struct Lane {
+        size_t msg;                   //!< Index of the message being hashed, or count if idle.
+        size_t pos;                   //!< Offset of the next full block of the message.
+        size_t full;                  //!< Number of bytes in full blocks of the message.
+        size_t tail_pos;              //!< Offset of the next block in tail.
+        size_t tail_len;              //!< Number of bytes in tail (64 or 128).
+        unsigned char tail[128];      //!< Padded last block(s) of the message.
+        unsigned char second[64];     //!< Padded input block of the second hash.
+        bool in_second;               //!< Whether the lane is hashing the second block.
+    };
+    static const unsigned char dummy[64] = {0};
+    static const uint32_t init[8] = {0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul, 0xa54ff53aul, 0x510e527ful, 0x9b05688cul, 0x1f83d9abul, 0x5be0cd19ul};
+
+    Lane lane_state[16];
+    uint32_t s[8 * 16];
+    const unsigned char* chunks[16];
+    size_t next = 0, active = 0;
+
+    auto start = [&](size_t lane) {
+        Lane& l = lane_state[lane];
+        for (int i = 0; i < 8; ++i) s[i * lanes + lane] = init[i];
+        l.in_second = false;
+        if (next == count) {
+            l.msg = count;
+            return;
+        }
+        l.msg = next++;
+        ++active;
+        const size_t len = lengths[l.msg];
+        l.pos = 0;
+        l.full = len & ~size_t{63};
+        const size_t rem = len - l.full;
+        l.tail_pos = 0;
+        l.tail_len = rem < 56 ? 64 : 128;
+        memset(l.tail, 0, l.tail_len);
+        if (rem) memcpy(l.tail, in[l.msg] + l.full, rem);
+        l.tail[rem] = 0x80;
+        WriteBE64(l.tail + l.tail_len - 8, uint64_t{len} << 3);
+    };
+
+    for (size_t lane = 0; lane < lanes; ++lane) start(lane);
+    while (active) {
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            const Lane& l = lane_state[lane];
+            if (l.msg == count) {
+                chunks[lane] = dummy;
+            } else if (l.in_second) {
+                chunks[lane] = l.second;
+            } else if (l.pos < l.full) {
+                chunks[lane] = in[l.msg] + l.pos;
+            } else {
+                chunks[lane] = l.tail + l.tail_pos;
+            }
+        }
+        TransformMulti(s, chunks);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            Lane& l = lane_state[lane];
+            if (l.msg == count) continue;
+            if (l.in_second) {
+                for (int i = 0; i < 8; ++i) WriteBE32(out + 32 * l.msg + 4 * i, s[i * lanes + lane]);
+                --active;
+                start(lane);
+            } else if (l.pos < l.full) {
+                l.pos += 64;
+            } else if ((l.tail_pos += 64) == l.tail_len) {
+                for (int i = 0; i < 8; ++i) {
+                    WriteBE32(l.second + 4 * i, s[i * lanes + lane]);
+                    s[i * lanes + lane] = init[i];
+                }
+                memset(l.second + 32, 0, 32);
+                l.second[32] = 0x80;
+                WriteBE64(l.second + 56, 256);
+                l.in_second = true;
+            }
+        }
+    }
+}
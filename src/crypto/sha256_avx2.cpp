@@ -59,6 +59,9 @@ __m256i inline Read8(const unsigned char* chunk, int offset) {
     return _mm256_shuffle_epi8(ret, _mm256_set_epi32(0x0C0D0E0FUL, 0x08090A0BUL, 0x04050607UL, 0x00010203UL, 0x0C0D0E0FUL, 0x08090A0BUL, 0x04050607UL, 0x00010203UL));
 }
 
+__m256i inline Load(const uint32_t* in) { return _mm256_loadu_si256((const __m256i*)in); }
+void inline Store(uint32_t* out, __m256i v) { _mm256_storeu_si256((__m256i*)out, v); }
+
 void inline Write8(unsigned char* out, int offset, __m256i v) {
     v = _mm256_shuffle_epi8(v, _mm256_set_epi32(0x0C0D0E0FUL, 0x08090A0BUL, 0x04050607UL, 0x00010203UL, 0x0C0D0E0FUL, 0x08090A0BUL, 0x04050607UL, 0x00010203UL));
     WriteLE32(out + 0 + offset, _mm256_extract_epi32(v, 7));
@@ -326,4 +329,80 @@ void Transform_8way(unsigned char* out, const unsigned char* in)
 
 }
 
+namespace sha256_avx2 {
+
+using namespace sha256d64_avx2;
+
+namespace {
+
+const uint32_t ROUND_CONSTANTS[64] = {
+    0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul, 0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
+    0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul, 0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
+    0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul, 0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
+    0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul, 0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
+    0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul, 0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+    0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul, 0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
+    0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul, 0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
+    0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul, 0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
+};
+
+__m256i inline ReadLanes(const unsigned char* const* chunks, int offset) {
+    return _mm256_setr_epi32(
+            ReadBE32(chunks[0] + offset),
+            ReadBE32(chunks[1] + offset),
+            ReadBE32(chunks[2] + offset),
+            ReadBE32(chunks[3] + offset),
+            ReadBE32(chunks[4] + offset),
+            ReadBE32(chunks[5] + offset),
+            ReadBE32(chunks[6] + offset),
+            ReadBE32(chunks[7] + offset)
+    );
+}
+
+}
+
+void TransformMulti_8way(uint32_t* s, const unsigned char* const* chunks)
+{
+    __m256i a = Load(s + 0 * 8);
+    __m256i b = Load(s + 1 * 8);
+    __m256i c = Load(s + 2 * 8);
+    __m256i d = Load(s + 3 * 8);
+    __m256i e = Load(s + 4 * 8);
+    __m256i f = Load(s + 5 * 8);
+    __m256i g = Load(s + 6 * 8);
+    __m256i h = Load(s + 7 * 8);
+
+    __m256i w[16];
+    for (int i = 0; i < 16; ++i) w[i] = ReadLanes(chunks, 4 * i);
+
+    for (int j = 0; j < 64; j += 16) {
+        if (j) {
+            for (int i = 0; i < 16; ++i) {
+                Inc(w[i], sigma1(w[(i + 14) & 15]), w[(i + 9) & 15], sigma0(w[(i + 1) & 15]));
+            }
+        }
+        for (int i = 0; i < 16; i += 8) {
+            Round(a, b, c, d, e, f, g, h, Add(K(ROUND_CONSTANTS[j + i + 0]), w[i + 0]));
+            Round(h, a, b, c, d, e, f, g, Add(K(ROUND_CONSTANTS[j + i + 1]), w[i + 1]));
+            Round(g, h, a, b, c, d, e, f, Add(K(ROUND_CONSTANTS[j + i + 2]), w[i + 2]));
+            Round(f, g, h, a, b, c, d, e, Add(K(ROUND_CONSTANTS[j + i + 3]), w[i + 3]));
+            Round(e, f, g, h, a, b, c, d, Add(K(ROUND_CONSTANTS[j + i + 4]), w[i + 4]));
+            Round(d, e, f, g, h, a, b, c, Add(K(ROUND_CONSTANTS[j + i + 5]), w[i + 5]));
+            Round(c, d, e, f, g, h, a, b, Add(K(ROUND_CONSTANTS[j + i + 6]), w[i + 6]));
+            Round(b, c, d, e, f, g, h, a, Add(K(ROUND_CONSTANTS[j + i + 7]), w[i + 7]));
+        }
+    }
+
+    Store(s + 0 * 8, Add(a, Load(s + 0 * 8)));
+    Store(s + 1 * 8, Add(b, Load(s + 1 * 8)));
+    Store(s + 2 * 8, Add(c, Load(s + 2 * 8)));
+    Store(s + 3 * 8, Add(d, Load(s + 3 * 8)));
+    Store(s + 4 * 8, Add(e, Load(s + 4 * 8)));
+    Store(s + 5 * 8, Add(f, Load(s + 5 * 8)));
+    Store(s + 6 * 8, Add(g, Load(s + 6 * 8)));
+    Store(s + 7 * 8, Add(h, Load(s + 7 * 8)));
+}
+
+}
+
 #endif
@@ -4,6 +4,8 @@
 
 #include <crypto/siphash.h>
 
+#include <crypto/common.h>
+
 #include <bit>
 
 #define SIPROUND do { \
@@ -52,6 +54,18 @@ CSipHasher& CSipHasher::Write(Span<const unsigned char> data)
     uint8_t c = count;
 
     while (data.size() > 0) {
+        if ((c & 7) == 0 && data.size() >= 8) {
+            // Whole words can be processed at once.
+            t = ReadLE64(data.data());
+            v3 ^= t;
+            SIPROUND;
+            SIPROUND;
+            v0 ^= t;
+            t = 0;
+            c += 8;
+            data = data.subspan(8);
+            continue;
+        }
         t |= uint64_t{data.front()} << (8 * (c % 8));
         c++;
         if ((c & 7) == 0) {
@@ -172,3 +186,59 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+namespace {
+
+/** SipHash rounds over several independent states at once, which lets the
+ *  compiler interleave (or vectorize) them. */
+constexpr size_t SIPHASH_LANES{4};
+
+inline void SipRoundLanes(uint64_t* v0, uint64_t* v1, uint64_t* v2, uint64_t* v3)
+{
+    for (size_t l = 0; l < SIPHASH_LANES; ++l) {
+        v0[l] += v1[l]; v1[l] = std::rotl(v1[l], 13); v1[l] ^= v0[l];
+        v0[l] = std::rotl(v0[l], 32);
+        v2[l] += v3[l]; v3[l] = std::rotl(v3[l], 16); v3[l] ^= v2[l];
+        v0[l] += v3[l]; v3[l] = std::rotl(v3[l], 21); v3[l] ^= v0[l];
+        v2[l] += v1[l]; v1[l] = std::rotl(v1[l], 17); v1[l] ^= v2[l];
+        v2[l] = std::rotl(v2[l], 32);
+    }
+}
+
+} // namespace
+
+void SipHashUint256Many(uint64_t k0, uint64_t k1, Span<const uint256> vals, uint64_t* out)
+{
+    size_t i = 0;
+    for (; i + SIPHASH_LANES <= vals.size(); i += SIPHASH_LANES) {
+        uint64_t v0[SIPHASH_LANES], v1[SIPHASH_LANES], v2[SIPHASH_LANES], v3[SIPHASH_LANES], d[SIPHASH_LANES];
+        for (size_t l = 0; l < SIPHASH_LANES; ++l) {
+            v0[l] = 0x736f6d6570736575ULL ^ k0;
+            v1[l] = 0x646f72616e646f6dULL ^ k1;
+            v2[l] = 0x6c7967656e657261ULL ^ k0;
+            v3[l] = 0x7465646279746573ULL ^ k1;
+        }
+        for (int word = 0; word < 4; ++word) {
+            for (size_t l = 0; l < SIPHASH_LANES; ++l) {
+                d[l] = vals[i + l].GetUint64(word);
+                v3[l] ^= d[l];
+            }
+            SipRoundLanes(v0, v1, v2, v3);
+            SipRoundLanes(v0, v1, v2, v3);
+            for (size_t l = 0; l < SIPHASH_LANES; ++l) v0[l] ^= d[l];
+        }
+        for (size_t l = 0; l < SIPHASH_LANES; ++l) v3[l] ^= (uint64_t{4}) << 59;
+        SipRoundLanes(v0, v1, v2, v3);
+        SipRoundLanes(v0, v1, v2, v3);
+        for (size_t l = 0; l < SIPHASH_LANES; ++l) {
+            v0[l] ^= (uint64_t{4}) << 59;
+            v2[l] ^= 0xFF;
+        }
+        SipRoundLanes(v0, v1, v2, v3);
+        SipRoundLanes(v0, v1, v2, v3);
+        SipRoundLanes(v0, v1, v2, v3);
+        SipRoundLanes(v0, v1, v2, v3);
+        for (size_t l = 0; l < SIPHASH_LANES; ++l) out[i + l] = v0[l] ^ v1[l] ^ v2[l] ^ v3[l];
+    }
+    for (; i < vals.size(); ++i) out[i] = SipHashUint256(k0, k1, vals[i]);
+}
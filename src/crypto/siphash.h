@@ -45,4 +45,7 @@ public:
 uint64_t SipHashUint256(uint64_t k0, uint64_t k1, const uint256& val);
 uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint32_t extra);
 
+/** Compute out[i] = SipHashUint256(k0, k1, vals[i]) for all i, several hashes at a time. */
+void SipHashUint256Many(uint64_t k0, uint64_t k1, Span<const uint256> vals, uint64_t* out);
+
 #endif // BITCOIN_CRYPTO_SIPHASH_H
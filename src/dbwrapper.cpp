@@ -335,11 +335,24 @@ std::vector<unsigned char> CDBWrapper::CreateObfuscateKey() const
     return ret;
 }
 
-std::optional<std::string> CDBWrapper::ReadImpl(Span<const std::byte> key) const
+struct DBSnapshot {
+    leveldb::DB* const db;
+    const leveldb::Snapshot* const snapshot;
+
+    explicit DBSnapshot(leveldb::DB* _db) : db{_db}, snapshot{_db->GetSnapshot()} {}
+    ~DBSnapshot() { db->ReleaseSnapshot(snapshot); }
+
+    DBSnapshot(const DBSnapshot&) = delete;
+    DBSnapshot& operator=(const DBSnapshot&) = delete;
+};
+
+std::optional<std::string> CDBWrapper::ReadImpl(Span<const std::byte> key, const DBSnapshot* snapshot) const
 {
     leveldb::Slice slKey(CharCast(key.data()), key.size());
     std::string strValue;
-    leveldb::Status status = DBContext().pdb->Get(DBContext().readoptions, slKey, &strValue);
+    leveldb::ReadOptions readoptions{DBContext().readoptions};
+    if (snapshot) readoptions.snapshot = snapshot->snapshot;
+    leveldb::Status status = DBContext().pdb->Get(readoptions, slKey, &strValue);
     if (!status.ok()) {
         if (status.IsNotFound())
             return std::nullopt;
@@ -381,18 +394,28 @@ bool CDBWrapper::IsEmpty()
     return !(it->Valid());
 }
 
+std::shared_ptr<const DBSnapshot> CDBWrapper::GetSnapshot() const
+{
+    return std::make_shared<const DBSnapshot>(DBContext().pdb);
+}
+
 struct CDBIterator::IteratorImpl {
+    //! kept alive until the iterator reading from it is destroyed
+    const std::shared_ptr<const DBSnapshot> snapshot;
     const std::unique_ptr<leveldb::Iterator> iter;
 
-    explicit IteratorImpl(leveldb::Iterator* _iter) : iter{_iter} {}
+    IteratorImpl(std::shared_ptr<const DBSnapshot> _snapshot, leveldb::Iterator* _iter) : snapshot{std::move(_snapshot)}, iter{_iter} {}
 };
 
 CDBIterator::CDBIterator(const CDBWrapper& _parent, std::unique_ptr<IteratorImpl> _piter) : parent(_parent),
                                                                                             m_impl_iter(std::move(_piter)) {}
 
-CDBIterator* CDBWrapper::NewIterator()
+CDBIterator* CDBWrapper::NewIterator(std::shared_ptr<const DBSnapshot> snapshot)
 {
-    return new CDBIterator{*this, std::make_unique<CDBIterator::IteratorImpl>(DBContext().pdb->NewIterator(DBContext().iteroptions))};
+    leveldb::ReadOptions iteroptions{DBContext().iteroptions};
+    if (snapshot) iteroptions.snapshot = snapshot->snapshot;
+    leveldb::Iterator* iter{DBContext().pdb->NewIterator(iteroptions)};
+    return new CDBIterator{*this, std::make_unique<CDBIterator::IteratorImpl>(std::move(snapshot), iter)};
 }
 
 void CDBIterator::SeekImpl(Span<const std::byte> key)
@@ -178,6 +178,10 @@ public:
 
 struct LevelDBContext;
 
+/** A consistent point-in-time view of the database, released when the last
+ * reference to it is dropped. Opaque outside of dbwrapper.cpp. */
+struct DBSnapshot;
+
 class CDBWrapper
 {
     friend const std::vector<unsigned char>& dbwrapper_private::GetObfuscateKey(const CDBWrapper &w);
@@ -205,7 +209,7 @@ private:
     //! whether or not the database resides in memory
     bool m_is_memory;
 
-    std::optional<std::string> ReadImpl(Span<const std::byte> key) const;
+    std::optional<std::string> ReadImpl(Span<const std::byte> key, const DBSnapshot* snapshot) const;
     bool ExistsImpl(Span<const std::byte> key) const;
     size_t EstimateSizeImpl(Span<const std::byte> key1, Span<const std::byte> key2) const;
     auto& DBContext() const LIFETIMEBOUND { return *Assert(m_db_context); }
@@ -217,13 +221,14 @@ public:
     CDBWrapper(const CDBWrapper&) = delete;
     CDBWrapper& operator=(const CDBWrapper&) = delete;
 
+    //! Read the value of key, as of snapshot if one is given
     template <typename K, typename V>
-    bool Read(const K& key, V& value) const
+    bool Read(const K& key, V& value, const DBSnapshot* snapshot = nullptr) const
     {
         DataStream ssKey{};
         ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
         ssKey << key;
-        std::optional<std::string> strValue{ReadImpl(ssKey)};
+        std::optional<std::string> strValue{ReadImpl(ssKey, snapshot)};
         if (!strValue) {
             return false;
         }
@@ -275,7 +280,11 @@ public:
     // Get an estimate of LevelDB memory usage (in bytes).
     size_t DynamicMemoryUsage() const;
 
-    CDBIterator* NewIterator();
+    //! Return an iterator over the current state, or over snapshot if one is given
+    CDBIterator* NewIterator(std::shared_ptr<const DBSnapshot> snapshot = nullptr);
+
+    //! Take a snapshot which reads and iterators can share to see the same state
+    std::shared_ptr<const DBSnapshot> GetSnapshot() const;
 
     /**
      * Return true if the database managed by this class contains no entries.
@@ -0,0 +1,373 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_FLATHASHMAP_H
+#define BITCOIN_FLATHASHMAP_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <utility>
+
+#include <util/fastrange.h>
+
+/**
+ * An open-addressing hash map that stores its entries inline in a single slot
+ * array, instead of allocating one node per entry like std::unordered_map.
+ *
+ * Each slot has a one byte control value next to it in a separate, densely
+ * packed array. A control byte is either EMPTY, DELETED (a tombstone), or
+ * holds the low 7 bits of the hash of the key in that slot. Lookups probe the
+ * control bytes linearly from the home slot of the key and only compare keys
+ * whose 7 bit fingerprint matches, so a lookup typically touches one cache
+ * line of control bytes plus the slot that holds the entry.
+ *
+ * Differences from std::unordered_map that callers must be aware of:
+ *
+ * - Inserting may rehash the table, which invalidates all iterators, pointers
+ *   and references into the map. Erasing never moves other entries, so erasing
+ *   while iterating is safe: erase(it) returns an iterator to the next entry.
+ *
+ * - The table only grows on insertion. Erased slots become tombstones that are
+ *   reused by later insertions and purged by the next rehash.
+ *
+ * The table is rehashed when the number of used (full or deleted) slots would
+ * exceed 7/8 of the capacity, doubling the capacity unless a capacity limit is
+ * set (see set_capacity_limit()).
+ */
+template <typename Key, typename T, typename Hash, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+private:
+    using ctrl_t = uint8_t;
+    static constexpr ctrl_t CTRL_EMPTY{0x80};
+    static constexpr ctrl_t CTRL_DELETED{0xfe};
+    static constexpr size_t MIN_CAPACITY{16};
+
+    static bool IsFull(ctrl_t c) { return (c & 0x80) == 0; }
+    static ctrl_t H2(size_t hash) { return static_cast<ctrl_t>(hash & 0x7f); }
+    static size_t MaxUsed(size_t capacity) { return capacity - capacity / 8; }
+
+    ctrl_t* m_ctrl{nullptr};
+    value_type* m_slots{nullptr};
+    size_t m_capacity{0};
+    size_t m_size{0};
+    //! Number of EMPTY slots that can still be filled before a rehash is needed
+    size_t m_growth_left{0};
+    size_t m_capacity_limit{SIZE_MAX};
+    Hash m_hash;
+    KeyEqual m_key_equal;
+
+    template <bool IS_CONST>
+    class Iter
+    {
+        friend class FlatHashMap;
+        template <bool>
+        friend class Iter;
+        using map_ptr = std::conditional_t<IS_CONST, const FlatHashMap*, FlatHashMap*>;
+        map_ptr m_map{nullptr};
+        size_t m_idx{0};
+
+        Iter(map_ptr map, size_t idx) : m_map{map}, m_idx{idx} {}
+        void SkipEmpty()
+        {
+            while (m_idx < m_map->m_capacity && !IsFull(m_map->m_ctrl[m_idx])) ++m_idx;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<const Key, T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IS_CONST, const value_type*, value_type*>;
+        using reference = std::conditional_t<IS_CONST, const value_type&, value_type&>;
+
+        Iter() = default;
+        //! Allow conversion from iterator to const_iterator.
+        template <bool OTHER_CONST, typename = std::enable_if_t<IS_CONST && !OTHER_CONST>>
+        Iter(const Iter<OTHER_CONST>& other) : m_map{other.m_map}, m_idx{other.m_idx} {}
+
+        reference operator*() const { return m_map->m_slots[m_idx]; }
+        pointer operator->() const { return &m_map->m_slots[m_idx]; }
+        Iter& operator++()
+        {
+            ++m_idx;
+            SkipEmpty();
+            return *this;
+        }
+        Iter operator++(int)
+        {
+            Iter copy{*this};
+            ++*this;
+            return copy;
+        }
+        template <bool OTHER_CONST>
+        bool operator==(const Iter<OTHER_CONST>& other) const { return m_idx == other.m_idx; }
+        template <bool OTHER_CONST>
+        bool operator!=(const Iter<OTHER_CONST>& other) const { return m_idx != other.m_idx; }
+    };
+
+public:
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    explicit FlatHashMap(const Hash& hash = Hash{}, const KeyEqual& key_equal = KeyEqual{})
+        : m_hash{hash}, m_key_equal{key_equal} {}
+
+    FlatHashMap(const FlatHashMap&) = delete;
+    FlatHashMap& operator=(const FlatHashMap&) = delete;
+
+    FlatHashMap(FlatHashMap&& other) noexcept
+        : m_ctrl{std::exchange(other.m_ctrl, nullptr)},
+          m_slots{std::exchange(other.m_slots, nullptr)},
+          m_capacity{std::exchange(other.m_capacity, 0)},
+          m_size{std::exchange(other.m_size, 0)},
+          m_growth_left{std::exchange(other.m_growth_left, 0)},
+          m_capacity_limit{other.m_capacity_limit},
+          m_hash{other.m_hash},
+          m_key_equal{other.m_key_equal} {}
+
+    FlatHashMap& operator=(FlatHashMap&&) = delete;
+
+    ~FlatHashMap() { Destroy(); }
+
+    iterator begin()
+    {
+        iterator it{this, 0};
+        if (m_capacity) it.SkipEmpty();
+        return it;
+    }
+    const_iterator begin() const
+    {
+        const_iterator it{this, 0};
+        if (m_capacity) it.SkipEmpty();
+        return it;
+    }
+    iterator end() { return {this, m_capacity}; }
+    const_iterator end() const { return {this, m_capacity}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const { return m_size == 0; }
+    size_type size() const { return m_size; }
+    //! Number of slots in the table. The map holds at most 7/8 of this many entries before it is rehashed.
+    size_type capacity() const { return m_capacity; }
+    hasher hash_function() const { return m_hash; }
+    key_equal key_eq() const { return m_key_equal; }
+
+    iterator find(const Key& key) { return {this, FindIndex(key)}; }
+    const_iterator find(const Key& key) const { return {this, FindIndex(key)}; }
+    size_type count(const Key& key) const { return FindIndex(key) != m_capacity; }
+
+    /** Insert a value constructed from args if key is not present yet. */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        const size_t hash{m_hash(key)};
+        auto [idx, found] = FindOrPrepareInsert(key, hash);
+        if (!found) {
+            ::new (static_cast<void*>(&m_slots[idx])) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+            ++m_size;
+        }
+        return {iterator{this, idx}, !found};
+    }
+
+    std::pair<iterator, bool> emplace(const Key& key, T&& value) { return try_emplace(key, std::move(value)); }
+    std::pair<iterator, bool> emplace(const Key& key, const T& value) { return try_emplace(key, value); }
+
+    T& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+    /** Erase the entry at pos and return an iterator to the next entry. No other entries are moved. */
+    iterator erase(const_iterator pos)
+    {
+        assert(pos.m_idx < m_capacity && IsFull(m_ctrl[pos.m_idx]));
+        EraseIndex(pos.m_idx);
+        iterator next{this, pos.m_idx};
+        ++next;
+        return next;
+    }
+    iterator erase(iterator pos) { return erase(const_iterator{pos}); }
+
+    size_type erase(const Key& key)
+    {
+        const size_t idx{FindIndex(key)};
+        if (idx == m_capacity) return 0;
+        EraseIndex(idx);
+        return 1;
+    }
+
+    /** Remove all entries, but keep the allocated table. */
+    void clear()
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (IsFull(m_ctrl[i])) m_slots[i].~value_type();
+        }
+        std::fill_n(m_ctrl, m_capacity, CTRL_EMPTY);
+        m_size = 0;
+        m_growth_left = MaxUsed(m_capacity);
+    }
+
+    /** Make sure count entries fit into the table without another rehash. */
+    void reserve(size_t count)
+    {
+        size_t capacity{std::max(MIN_CAPACITY, count + count / 7)};
+        while (MaxUsed(capacity) < count) ++capacity;
+        if (capacity > m_capacity) Rehash(capacity);
+    }
+
+    /**
+     * Limit the growth step that would cross limit slots. The table fills up
+     * to 7/8 of its slots and then normally doubles. If doubling would take it
+     * from below limit to above it, it grows to exactly limit slots instead,
+     * as long as that leaves room for the new entry. A table that has already
+     * reached the limit keeps doubling, so this is not a hard cap: it lets a
+     * caller that flushes the map once it exceeds a memory budget use all of
+     * that budget instead of overshooting it by up to a factor of two.
+     */
+    void set_capacity_limit(size_t limit) { m_capacity_limit = limit; }
+
+private:
+    size_t FindIndex(const Key& key) const
+    {
+        if (m_size == 0) return m_capacity;
+        const size_t hash{m_hash(key)};
+        const ctrl_t h2{H2(hash)};
+        for (size_t idx{HomeIndex(hash)};; idx = NextIndex(idx)) {
+            const ctrl_t c{m_ctrl[idx]};
+            if (c == h2 && m_key_equal(m_slots[idx].first, key)) return idx;
+            if (c == CTRL_EMPTY) return m_capacity;
+        }
+    }
+
+    /**
+     * Look up key. If it is not present, return the slot it should be
+     * inserted into, rehashing the table first when needed, and mark that slot
+     * as used. The caller must construct the entry in the returned slot.
+     */
+    std::pair<size_t, bool> FindOrPrepareInsert(const Key& key, size_t hash)
+    {
+        const ctrl_t h2{H2(hash)};
+        if (m_capacity > 0) {
+            size_t target{m_capacity};
+            for (size_t idx{HomeIndex(hash)};; idx = NextIndex(idx)) {
+                const ctrl_t c{m_ctrl[idx]};
+                if (c == h2 && m_key_equal(m_slots[idx].first, key)) return {idx, true};
+                if (c == CTRL_DELETED && target == m_capacity) target = idx;
+                if (c == CTRL_EMPTY) {
+                    if (target == m_capacity) target = idx;
+                    break;
+                }
+            }
+            // Reusing a tombstone never needs a rehash, filling an empty slot might.
+            if (m_ctrl[target] == CTRL_DELETED || m_growth_left > 0) {
+                if (m_ctrl[target] == CTRL_EMPTY) --m_growth_left;
+                m_ctrl[target] = h2;
+                return {target, false};
+            }
+        }
+        // Grow if the table is at least half full with live entries, otherwise
+        // rehash in place to purge the tombstones.
+        size_t new_capacity{m_capacity};
+        if (m_capacity == 0) {
+            new_capacity = MIN_CAPACITY;
+        } else if (m_size + 1 > MaxUsed(m_capacity) / 2) {
+            new_capacity = m_capacity * 2;
+            if (m_capacity < m_capacity_limit && new_capacity > m_capacity_limit && MaxUsed(m_capacity_limit) > m_size + 1) {
+                new_capacity = m_capacity_limit;
+            }
+        }
+        Rehash(new_capacity);
+        const size_t idx{FindEmpty(hash)};
+        --m_growth_left;
+        m_ctrl[idx] = h2;
+        return {idx, false};
+    }
+
+    //! The capacity need not be a power of two, so map the hash to a slot by multiplication instead
+    //! of masking. This uses the high bits of the hash, which are independent of the fingerprint.
+    size_t HomeIndex(size_t hash) const
+    {
+        if constexpr (sizeof(size_t) < sizeof(uint64_t)) return FastRange32(hash, m_capacity);
+        return FastRange64(hash, m_capacity);
+    }
+    size_t NextIndex(size_t idx) const { return idx + 1 == m_capacity ? 0 : idx + 1; }
+
+    //! Only valid on a table without tombstones.
+    size_t FindEmpty(size_t hash) const
+    {
+        size_t idx{HomeIndex(hash)};
+        while (m_ctrl[idx] != CTRL_EMPTY) idx = NextIndex(idx);
+        return idx;
+    }
+
+    void EraseIndex(size_t idx)
+    {
+        m_slots[idx].~value_type();
+        --m_size;
+        // With linear probing, no probe sequence can pass through idx if the
+        // next slot is empty, so the slot can be marked empty instead of
+        // leaving a tombstone.
+        if (m_ctrl[NextIndex(idx)] == CTRL_EMPTY) {
+            m_ctrl[idx] = CTRL_EMPTY;
+            ++m_growth_left;
+        } else {
+            m_ctrl[idx] = CTRL_DELETED;
+        }
+    }
+
+    void Rehash(size_t new_capacity)
+    {
+        assert(new_capacity >= MIN_CAPACITY && MaxUsed(new_capacity) > m_size);
+        ctrl_t* const old_ctrl{m_ctrl};
+        value_type* const old_slots{m_slots};
+        const size_t old_capacity{m_capacity};
+
+        m_ctrl = std::allocator<ctrl_t>{}.allocate(new_capacity);
+        m_slots = std::allocator<value_type>{}.allocate(new_capacity);
+        std::fill_n(m_ctrl, new_capacity, CTRL_EMPTY);
+        m_capacity = new_capacity;
+        m_growth_left = MaxUsed(new_capacity) - m_size;
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (!IsFull(old_ctrl[i])) continue;
+            const size_t hash{m_hash(old_slots[i].first)};
+            const size_t idx{FindEmpty(hash)};
+            m_ctrl[idx] = H2(hash);
+            ::new (static_cast<void*>(&m_slots[idx])) value_type(std::move(old_slots[i]));
+            old_slots[i].~value_type();
+        }
+        if (old_capacity) {
+            std::allocator<ctrl_t>{}.deallocate(old_ctrl, old_capacity);
+            std::allocator<value_type>{}.deallocate(old_slots, old_capacity);
+        }
+    }
+
+    void Destroy()
+    {
+        if (m_capacity == 0) return;
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (IsFull(m_ctrl[i])) m_slots[i].~value_type();
+        }
+        std::allocator<ctrl_t>{}.deallocate(m_ctrl, m_capacity);
+        std::allocator<value_type>{}.deallocate(m_slots, m_capacity);
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+        m_capacity = m_size = m_growth_left = 0;
+    }
+};
+
+#endif // BITCOIN_FLATHASHMAP_H
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <chainparams.h>
+#include <checkqueue.h>
 #include <common/args.h>
 #include <index/base.h>
 #include <interfaces/chain.h>
@@ -14,18 +15,40 @@
 #include <node/database_args.h>
 #include <node/interface_ui.h>
 #include <tinyformat.h>
+#include <undo.h>
 #include <util/thread.h>
 #include <util/translation.h>
 #include <validation.h> // For g_chainman
 #include <warnings.h>
 
+#include <algorithm>
+#include <functional>
 #include <string>
 #include <utility>
+#include <vector>
 
 constexpr uint8_t DB_BEST_BLOCK{'B'};
 
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
+//! How many blocks per thread the initial sync reads ahead of the block being appended
+constexpr size_t SYNC_BLOCKS_PER_THREAD{4};
+
+struct BaseIndex::SyncBlock {
+    const CBlockIndex* pindex{nullptr};
+    CBlock block;
+    CBlockUndo undo;
+    std::any prepared;
+    bool read_ok{false};
+    bool prepare_ok{false};
+
+    interfaces::BlockInfo GetInfo(bool with_undo) const
+    {
+        interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, &block);
+        if (with_undo && pindex->nHeight > 0) block_info.undo_data = &undo;
+        return block_info;
+    }
+};
 
 template <typename... Args>
 void BaseIndex::FatalErrorf(const char* fmt, const Args&... args)
@@ -141,10 +164,27 @@ static const CBlockIndex* NextSyncBlock(const CBlockIndex* pindex_prev, CChain&
     return chain.Next(chain.FindFork(pindex_prev));
 }
 
+void BaseIndex::ReadSyncBlock(SyncBlock& sync_block) const
+{
+    if (!m_chainstate->m_blockman.ReadBlockFromDisk(sync_block.block, *sync_block.pindex)) return;
+    sync_block.read_ok = true;
+    if (CustomNeedsUndoData() && sync_block.pindex->nHeight > 0 &&
+        !m_chainstate->m_blockman.UndoReadFromDisk(sync_block.undo, *sync_block.pindex)) {
+        return;
+    }
+    sync_block.prepare_ok = CustomPrepare(sync_block.GetInfo(CustomNeedsUndoData()), sync_block.prepared);
+}
+
 void BaseIndex::ThreadSync()
 {
     const CBlockIndex* pindex = m_best_block_index.load();
     if (!m_synced) {
+        const int sync_threads_num{int(std::clamp<int64_t>(gArgs.GetIntArg("-indexsyncthreads", DEFAULT_INDEX_SYNC_THREADS), 0, MAX_INDEX_SYNC_THREADS))};
+        CCheckQueue<std::function<bool()>> sync_queue{/*batch_size=*/1, sync_threads_num, "idxsync"};
+        const size_t window_size{(sync_threads_num + 1) * SYNC_BLOCKS_PER_THREAD};
+        // Blocks read and prepared, to be appended next.
+        std::vector<SyncBlock> pending;
+
         std::chrono::steady_clock::time_point last_log_time{0s};
         std::chrono::steady_clock::time_point last_locator_write_time{0s};
         while (true) {
@@ -159,52 +199,77 @@ void BaseIndex::ThreadSync()
                 return;
             }
 
+            // Pick the blocks following the pending ones, up to the next fork.
+            std::vector<SyncBlock> window;
             {
                 LOCK(cs_main);
-                const CBlockIndex* pindex_next = NextSyncBlock(pindex, m_chainstate->m_chain);
-                if (!pindex_next) {
+                const CBlockIndex* pindex_prev = pending.empty() ? pindex : pending.back().pindex;
+                while (window.size() < window_size) {
+                    const CBlockIndex* pindex_next = NextSyncBlock(pindex_prev, m_chainstate->m_chain);
+                    if (!pindex_next) break;
+                    if (pindex_next->pprev != pindex_prev) {
+                        // Rewinding requires all blocks before the fork to be appended.
+                        if (!pending.empty() || !window.empty()) break;
+                        if (!Rewind(pindex, pindex_next->pprev)) {
+                            FatalErrorf("%s: Failed to rewind index %s to a previous chain tip",
+                                       __func__, GetName());
+                            return;
+                        }
+                        pindex = pindex_next->pprev;
+                    }
+                    window.emplace_back().pindex = pindex_next;
+                    pindex_prev = pindex_next;
+                }
+                if (window.empty() && pending.empty()) {
                     SetBestBlockIndex(pindex);
                     m_synced = true;
                     // No need to handle errors in Commit. See rationale above.
                     Commit();
                     break;
                 }
-                if (pindex_next->pprev != pindex && !Rewind(pindex, pindex_next->pprev)) {
-                    FatalErrorf("%s: Failed to rewind index %s to a previous chain tip",
-                               __func__, GetName());
-                    return;
-                }
-                pindex = pindex_next;
             }
 
-            auto current_time{std::chrono::steady_clock::now()};
-            if (last_log_time + SYNC_LOG_INTERVAL < current_time) {
-                LogPrintf("Syncing %s with block chain from height %d\n",
-                          GetName(), pindex->nHeight);
-                last_log_time = current_time;
+            // Have the worker threads read and prepare the window, while the pending
+            // blocks are appended. The control waits for the workers when going out of
+            // scope, before the window does.
+            CCheckQueueControl<std::function<bool()>> control(&sync_queue);
+            for (SyncBlock& sync_block : window) {
+                control.Add({[this, &sync_block] { ReadSyncBlock(sync_block); return true; }});
             }
 
-            if (last_locator_write_time + SYNC_LOCATOR_WRITE_INTERVAL < current_time) {
-                SetBestBlockIndex(pindex->pprev);
-                last_locator_write_time = current_time;
-                // No need to handle errors in Commit. See rationale above.
-                Commit();
-            }
+            for (SyncBlock& sync_block : pending) {
+                if (m_interrupt) break;
 
-            CBlock block;
-            interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex);
-            if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, *pindex)) {
-                FatalErrorf("%s: Failed to read block %s from disk",
-                           __func__, pindex->GetBlockHash().ToString());
-                return;
-            } else {
-                block_info.data = &block;
-            }
-            if (!CustomAppend(block_info)) {
-                FatalErrorf("%s: Failed to write block %s to index database",
-                           __func__, pindex->GetBlockHash().ToString());
-                return;
+                auto current_time{std::chrono::steady_clock::now()};
+                if (last_log_time + SYNC_LOG_INTERVAL < current_time) {
+                    LogPrintf("Syncing %s with block chain from height %d\n",
+                              GetName(), sync_block.pindex->nHeight);
+                    last_log_time = current_time;
+                }
+
+                if (last_locator_write_time + SYNC_LOCATOR_WRITE_INTERVAL < current_time) {
+                    SetBestBlockIndex(pindex);
+                    last_locator_write_time = current_time;
+                    // No need to handle errors in Commit. See rationale above.
+                    Commit();
+                }
+
+                if (!sync_block.read_ok) {
+                    FatalErrorf("%s: Failed to read block %s from disk",
+                               __func__, sync_block.pindex->GetBlockHash().ToString());
+                    return;
+                }
+                if (!sync_block.prepare_ok ||
+                    !CustomAppendPrepared(sync_block.GetInfo(CustomNeedsUndoData()), std::move(sync_block.prepared))) {
+                    FatalErrorf("%s: Failed to write block %s to index database",
+                               __func__, sync_block.pindex->GetBlockHash().ToString());
+                    return;
+                }
+                pindex = sync_block.pindex;
             }
+
+            control.Wait();
+            pending = std::move(window);
         }
     }
 
@@ -10,8 +10,14 @@
 #include <util/threadinterrupt.h>
 #include <validationinterface.h>
 
+#include <any>
 #include <string>
 
+/** Default number of threads reading and preparing blocks during the initial sync of an index */
+static constexpr int DEFAULT_INDEX_SYNC_THREADS{2};
+/** Maximum number of threads reading and preparing blocks during the initial sync of an index */
+static constexpr int MAX_INDEX_SYNC_THREADS{16};
+
 class CBlock;
 class CBlockIndex;
 class Chainstate;
@@ -78,13 +84,23 @@ private:
     std::thread m_thread_sync;
     CThreadInterrupt m_interrupt;
 
+    /// A block of the initial sync, with the results of reading and preparing it.
+    struct SyncBlock;
+
     /// Sync the index with the block index starting from the current best block.
     /// Intended to be run in its own thread, m_thread_sync, and can be
     /// interrupted with m_interrupt. Once the index gets in sync, the m_synced
     /// flag is set and the BlockConnected ValidationInterface callback takes
     /// over and the sync thread exits.
+    ///
+    /// Worker threads (-indexsyncthreads) read and prepare the upcoming blocks
+    /// while the sync thread appends the previous ones in order.
     void ThreadSync();
 
+    /// Read a block (and its undo data, if needed) and call CustomPrepare() for
+    /// it. Called from the worker threads of ThreadSync().
+    void ReadSyncBlock(SyncBlock& sync_block) const;
+
     /// Write the current index state (eg. chain block locator and subclass-specific items) to disk.
     ///
     /// Recommendations for error handling:
@@ -118,6 +134,18 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Whether CustomAppend() uses the undo data of blocks. If so, the initial
+    /// sync reads it ahead and passes it in BlockInfo::undo_data.
+    virtual bool CustomNeedsUndoData() const { return false; }
+
+    /// Compute the parts of the index entries of a block which do not depend on
+    /// previous blocks. During the initial sync, this is called on worker threads,
+    /// concurrently for several blocks, ahead of CustomAppendPrepared() for them.
+    [[nodiscard]] virtual bool CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) const { return true; }
+
+    /// Write the index entries of a block, given the result of CustomPrepare() for it.
+    [[nodiscard]] virtual bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) { return CustomAppend(block); }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
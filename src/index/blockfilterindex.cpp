@@ -217,17 +217,31 @@ size_t BlockFilterIndex::WriteFilterToDisk(FlatFilePos& pos, const BlockFilter&
 
 bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
 {
-    CBlockUndo block_undo;
-    uint256 prev_header;
+    std::any prepared;
+    return CustomPrepare(block, prepared) && CustomAppendPrepared(block, std::move(prepared));
+}
 
-    if (block.height > 0) {
+bool BlockFilterIndex::CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) const
+{
+    CBlockUndo block_undo;
+    if (block.height > 0 && !block.undo_data) {
         // pindex variable gives indexing code access to node internals. It
         // will be removed in upcoming commit
         const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
         if (!m_chainstate->m_blockman.UndoReadFromDisk(block_undo, *pindex)) {
             return false;
         }
+    }
 
+    prepared = BlockFilter(m_filter_type, *Assert(block.data), block.undo_data ? *block.undo_data : block_undo);
+    return true;
+}
+
+bool BlockFilterIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    uint256 prev_header;
+
+    if (block.height > 0) {
         std::pair<uint256, DBVal> read_out;
         if (!m_db->Read(DBHeightKey(block.height - 1), read_out)) {
             return false;
@@ -242,7 +256,7 @@ bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
         prev_header = read_out.second.header;
     }
 
-    BlockFilter filter(m_filter_type, *Assert(block.data), block_undo);
+    const BlockFilter& filter{std::any_cast<const BlockFilter&>(prepared)};
 
     size_t bytes_written = WriteFilterToDisk(m_next_filter_pos, filter);
     if (bytes_written == 0) return false;
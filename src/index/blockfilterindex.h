@@ -51,6 +51,12 @@ protected:
 
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    bool CustomNeedsUndoData() const override { return true; }
+
+    bool CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
     bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
 
     BaseIndex::DB& GetDB() const LIFETIMEBOUND override { return *m_db; }
@@ -0,0 +1,286 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/scriptindex.h>
+
+#include <common/args.h>
+#include <crypto/siphash.h>
+#include <dbwrapper.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <random.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <undo.h>
+#include <validation.h>
+
+/* The index database stores one item for each output paying to a script and
+ * one for each input spending such an output. Both are keyed by the script
+ * they pay to:
+ *
+ * Keys have the type [DB_SCRIPT, uint64 script id, uint32 (BE) height, uint8 kind, COutPoint].
+ * The height is represented as big-endian so that the entries of a script are
+ * sorted by height, and lookups can start at a given height. The outpoint is
+ * the output created or spent.
+ * Values of funding entries are the amount of the output (as a VARINT), values
+ * of spending entries are the txid and input index of the spending transaction
+ * followed by the amount.
+ *
+ * The script id is a SipHash of the scriptPubKey, keyed with a salt stored
+ * under DB_SALT when the database is created.
+ */
+constexpr uint8_t DB_SCRIPT{'s'};
+constexpr uint8_t DB_SALT{'S'};
+
+constexpr uint8_t KIND_FUNDING{0};
+constexpr uint8_t KIND_SPENDING{1};
+
+std::unique_ptr<ScriptIndex> g_scriptindex;
+
+namespace {
+
+struct DBKeyPrefix {
+    uint64_t script_id;
+    int height;
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_SCRIPT);
+        ser_writedata64(s, script_id);
+        ser_writedata32be(s, height);
+    }
+};
+
+struct DBKey {
+    uint64_t script_id;
+    int height;
+    uint8_t kind;
+    COutPoint outpoint;
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_SCRIPT);
+        ser_writedata64(s, script_id);
+        ser_writedata32be(s, height);
+        ser_writedata8(s, kind);
+        s << outpoint;
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_SCRIPT) {
+            throw std::ios_base::failure("Invalid format for script index DB key");
+        }
+        script_id = ser_readdata64(s);
+        height = ser_readdata32be(s);
+        kind = ser_readdata8(s);
+        s >> outpoint;
+    }
+};
+
+struct DBFundingVal {
+    CAmount amount;
+
+    SERIALIZE_METHODS(DBFundingVal, obj) { READWRITE(VARINT_MODE(obj.amount, VarIntMode::NONNEGATIVE_SIGNED)); }
+};
+
+struct DBSpendingVal {
+    Txid txid;
+    uint32_t vin;
+    CAmount amount;
+
+    SERIALIZE_METHODS(DBSpendingVal, obj) { READWRITE(obj.txid, VARINT(obj.vin), VARINT_MODE(obj.amount, VarIntMode::NONNEGATIVE_SIGNED)); }
+};
+
+} // namespace
+
+struct ScriptIndex::DBEntry {
+    DBKey key;
+    CAmount amount;
+    Txid spending_txid;
+    uint32_t spending_vin;
+};
+
+/** Access to the scriptindex database (indexes/scriptindex/) */
+class ScriptIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Write a batch of index entries to the DB.
+    [[nodiscard]] bool WriteEntries(const std::vector<DBEntry>& entries);
+
+    /// Erase a batch of index entries from the DB.
+    [[nodiscard]] bool EraseEntries(const std::vector<DBEntry>& entries);
+};
+
+ScriptIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "scriptindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool ScriptIndex::DB::WriteEntries(const std::vector<DBEntry>& entries)
+{
+    CDBBatch batch(*this);
+    for (const DBEntry& entry : entries) {
+        if (entry.key.kind == KIND_FUNDING) {
+            batch.Write(entry.key, DBFundingVal{entry.amount});
+        } else {
+            batch.Write(entry.key, DBSpendingVal{entry.spending_txid, entry.spending_vin, entry.amount});
+        }
+    }
+    return WriteBatch(batch);
+}
+
+bool ScriptIndex::DB::EraseEntries(const std::vector<DBEntry>& entries)
+{
+    CDBBatch batch(*this);
+    for (const DBEntry& entry : entries) {
+        batch.Erase(entry.key);
+    }
+    return WriteBatch(batch);
+}
+
+ScriptIndex::ScriptIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "scriptindex"), m_db(std::make_unique<ScriptIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+ScriptIndex::~ScriptIndex() = default;
+
+bool ScriptIndex::CustomInit(const std::optional<interfaces::BlockKey>& block)
+{
+    std::pair<uint64_t, uint64_t> salt;
+    if (!m_db->Read(DB_SALT, salt)) {
+        // Without its salt, the entries of an index that has synced some blocks are lost.
+        if (block || m_db->Exists(DB_SALT)) {
+            return error("%s: Cannot read the salt of %s; index may be corrupted",
+                         __func__, GetName());
+        }
+        salt = {GetRand<uint64_t>(), GetRand<uint64_t>()};
+        if (!m_db->Write(DB_SALT, salt, /*fSync=*/true)) {
+            return error("%s: Failed to write the salt of %s", __func__, GetName());
+        }
+    }
+    std::tie(m_k0, m_k1) = salt;
+    return true;
+}
+
+uint64_t ScriptIndex::ScriptId(const CScript& script) const
+{
+    return CSipHasher(m_k0, m_k1).Write(MakeUCharSpan(script)).Finalize();
+}
+
+void ScriptIndex::BlockEntries(const CBlock& block, const CBlockUndo& block_undo, int height, std::vector<DBEntry>& entries) const
+{
+    for (size_t i = 0; i < block.vtx.size(); ++i) {
+        const CTransaction& tx{*block.vtx[i]};
+        for (uint32_t n = 0; n < tx.vout.size(); ++n) {
+            const CTxOut& txout{tx.vout[n]};
+            if (txout.scriptPubKey.IsUnspendable()) continue;
+            entries.push_back({{ScriptId(txout.scriptPubKey), height, KIND_FUNDING, COutPoint{tx.GetHash(), n}}, txout.nValue, Txid{}, 0});
+        }
+        if (tx.IsCoinBase()) continue;
+        const CTxUndo& tx_undo{block_undo.vtxundo.at(i - 1)};
+        for (uint32_t n = 0; n < tx.vin.size(); ++n) {
+            const CTxOut& prevout{tx_undo.vprevout.at(n).out};
+            entries.push_back({{ScriptId(prevout.scriptPubKey), height, KIND_SPENDING, tx.vin[n].prevout}, prevout.nValue, tx.GetHash(), n});
+        }
+    }
+}
+
+bool ScriptIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    std::any prepared;
+    return CustomPrepare(block, prepared) && CustomAppendPrepared(block, std::move(prepared));
+}
+
+bool ScriptIndex::CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) const
+{
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (block.height == 0) return true;
+
+    CBlockUndo block_undo;
+    if (!block.undo_data) {
+        const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
+        if (!m_chainstate->m_blockman.UndoReadFromDisk(block_undo, *pindex)) {
+            return false;
+        }
+    }
+
+    std::vector<DBEntry> entries;
+    BlockEntries(*Assert(block.data), block.undo_data ? *block.undo_data : block_undo, block.height, entries);
+    prepared = std::move(entries);
+    return true;
+}
+
+bool ScriptIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    if (block.height == 0) return true;
+
+    return m_db->WriteEntries(std::any_cast<const std::vector<DBEntry>&>(prepared));
+}
+
+bool ScriptIndex::CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip)
+{
+    LOCK(cs_main);
+    const CBlockIndex* iter_tip{m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash)};
+    const CBlockIndex* new_tip_index{m_chainstate->m_blockman.LookupBlockIndex(new_tip.hash)};
+
+    do {
+        CBlock block;
+        CBlockUndo block_undo;
+        if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, *iter_tip)) {
+            return error("%s: Failed to read block %s from disk",
+                         __func__, iter_tip->GetBlockHash().ToString());
+        }
+        if (!m_chainstate->m_blockman.UndoReadFromDisk(block_undo, *iter_tip)) {
+            return error("%s: Failed to read undo data of block %s from disk",
+                         __func__, iter_tip->GetBlockHash().ToString());
+        }
+
+        std::vector<DBEntry> entries;
+        BlockEntries(block, block_undo, iter_tip->nHeight, entries);
+        if (!m_db->EraseEntries(entries)) return false;
+
+        iter_tip = iter_tip->GetAncestor(iter_tip->nHeight - 1);
+    } while (new_tip_index != iter_tip);
+
+    return true;
+}
+
+BaseIndex::DB& ScriptIndex::GetDB() const { return *m_db; }
+
+bool ScriptIndex::FindScriptHistory(const CScript& script, int start_height, std::vector<ScriptHistoryEntry>& entries) const
+{
+    const uint64_t script_id{ScriptId(script)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    for (db_it->Seek(DBKeyPrefix{script_id, std::max(start_height, 0)}); db_it->Valid(); db_it->Next()) {
+        DBKey key;
+        if (!db_it->GetKey(key) || key.script_id != script_id) break;
+
+        ScriptHistoryEntry& entry{entries.emplace_back()};
+        entry.height = key.height;
+        entry.spending = key.kind == KIND_SPENDING;
+        entry.outpoint = key.outpoint;
+        if (entry.spending) {
+            DBSpendingVal value;
+            if (!db_it->GetValue(value)) {
+                return error("%s: Cannot read spending entry of %s from %s", __func__, key.outpoint.ToString(), GetName());
+            }
+            entry.amount = value.amount;
+            entry.spending_txid = value.txid;
+            entry.spending_vin = value.vin;
+        } else {
+            DBFundingVal value;
+            if (!db_it->GetValue(value)) {
+                return error("%s: Cannot read funding entry of %s from %s", __func__, key.outpoint.ToString(), GetName());
+            }
+            entry.amount = value.amount;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,106 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SCRIPTINDEX_H
+#define BITCOIN_INDEX_SCRIPTINDEX_H
+
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <primitives/transaction.h>
+
+#include <cstdint>
+#include <vector>
+
+class CBlock;
+class CBlockUndo;
+class CScript;
+
+static constexpr bool DEFAULT_SCRIPTINDEX{false};
+
+/** An output paying to a script, or the spend of such an output, as found in the script index. */
+struct ScriptHistoryEntry {
+    /// Height of the block which created (or spent) the output.
+    int height;
+    /// Whether this entry records the spend of the output rather than its creation.
+    bool spending;
+    /// The output paying to the script.
+    COutPoint outpoint;
+    /// The value of the output.
+    CAmount amount;
+    /// For spends, the spending transaction and the index of its input spending the output.
+    Txid spending_txid;
+    uint32_t spending_vin{0};
+};
+
+/**
+ * ScriptIndex is used to look up the history of a scriptPubKey without
+ * scanning the UTXO set or the block chain. The index is written to a LevelDB
+ * database and records, for each script, the outputs paying to it and the
+ * inputs spending those outputs, ordered by block height.
+ *
+ * Scripts are keyed by an 8-byte SipHash of the scriptPubKey, salted with a
+ * random key generated when the database is created, so that keys stay
+ * compact and collisions can not be ground by third parties.
+ */
+class ScriptIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    /// The salt of the script ids, read from or written to the database by CustomInit().
+    uint64_t m_k0{0}, m_k1{0};
+
+    bool AllowPrune() const override { return false; }
+
+    /// Compact id of a script in the database.
+    uint64_t ScriptId(const CScript& script) const;
+
+    /// A database entry of the index.
+    struct DBEntry;
+
+    /// Collect the index entries of a block.
+    void BlockEntries(const CBlock& block, const CBlockUndo& block_undo, int height, std::vector<DBEntry>& entries) const;
+
+protected:
+    bool CustomInit(const std::optional<interfaces::BlockKey>& block) override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool CustomNeedsUndoData() const override { return true; }
+
+    bool CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
+    bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit ScriptIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~ScriptIndex() override;
+
+    /// Look up the outputs paying to a script and their spends.
+    ///
+    /// Because scripts are identified by a 64-bit hash, entries of an unrelated
+    /// script may be returned with negligible probability. Callers needing
+    /// certainty should compare the script of the outputs.
+    ///
+    /// @param[in]   script  The scriptPubKey to look up.
+    /// @param[in]   start_height  Skip entries of blocks below this height.
+    /// @param[out]  entries  The entries found are appended, ordered by height.
+    /// @return  false on a database error, true otherwise
+    bool FindScriptHistory(const CScript& script, int start_height, std::vector<ScriptHistoryEntry>& entries) const;
+};
+
+/// The global script index. May be null.
+extern std::unique_ptr<ScriptIndex> g_scriptindex;
+
+#endif // BITCOIN_INDEX_SCRIPTINDEX_H
@@ -55,6 +55,12 @@ TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size,
 TxIndex::~TxIndex() = default;
 
 bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    std::any prepared;
+    return CustomPrepare(block, prepared) && CustomAppendPrepared(block, std::move(prepared));
+}
+
+bool TxIndex::CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) const
 {
     // Exclude genesis block transaction because outputs are not spendable.
     if (block.height == 0) return true;
@@ -67,7 +73,15 @@ bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
         vPos.emplace_back(tx->GetHash(), pos);
         pos.nTxOffset += ::GetSerializeSize(TX_WITH_WITNESS(*tx));
     }
-    return m_db->WriteTxs(vPos);
+    prepared = std::move(vPos);
+    return true;
+}
+
+bool TxIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    if (block.height == 0) return true;
+
+    return m_db->WriteTxs(std::any_cast<const std::vector<std::pair<uint256, CDiskTxPos>>&>(prepared));
 }
 
 BaseIndex::DB& TxIndex::GetDB() const { return *m_db; }
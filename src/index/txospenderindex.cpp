@@ -0,0 +1,240 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/txospenderindex.h>
+
+#include <common/args.h>
+#include <crypto/siphash.h>
+#include <dbwrapper.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <random.h>
+#include <serialize.h>
+#include <tinyformat.h>
+#include <util/translation.h>
+#include <validation.h>
+
+/* The index database stores one item for each spent output:
+ *
+ * Keys have the type [DB_TXOSPENDERINDEX, uint64 outpoint id, CDiskTxPos], where
+ * the position is that of the spending transaction. Values are unused.
+ * Keeping the position in the key lets outpoints with the same id coexist,
+ * and lets the entries of a block be written without reading the database.
+ *
+ * The outpoint id is a SipHash of the outpoint, keyed with a salt stored under
+ * DB_SALT when the database is created.
+ */
+constexpr uint8_t DB_TXOSPENDERINDEX{'s'};
+constexpr uint8_t DB_SALT{'S'};
+
+std::unique_ptr<TxoSpenderIndex> g_txospenderindex;
+
+namespace {
+
+struct DBKey {
+    uint64_t outpoint_id;
+    CDiskTxPos pos;
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_TXOSPENDERINDEX);
+        ser_writedata64(s, outpoint_id);
+        s << pos;
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_TXOSPENDERINDEX) {
+            throw std::ios_base::failure("Invalid format for spent output index DB key");
+        }
+        outpoint_id = ser_readdata64(s);
+        s >> pos;
+    }
+};
+
+struct DBKeyPrefix {
+    uint64_t outpoint_id;
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_TXOSPENDERINDEX);
+        ser_writedata64(s, outpoint_id);
+    }
+};
+
+} // namespace
+
+/** Access to the txospenderindex database (indexes/txospenderindex/) */
+class TxoSpenderIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Write a batch of spends to the DB.
+    [[nodiscard]] bool WriteSpends(const std::vector<std::pair<uint64_t, CDiskTxPos>>& spends);
+
+    /// Erase a batch of spends from the DB.
+    [[nodiscard]] bool EraseSpends(const std::vector<std::pair<uint64_t, CDiskTxPos>>& spends);
+
+    /// Read the positions of the transactions spending outputs with the given id.
+    std::vector<CDiskTxPos> ReadSpenderPositions(uint64_t outpoint_id);
+};
+
+TxoSpenderIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "txospenderindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool TxoSpenderIndex::DB::WriteSpends(const std::vector<std::pair<uint64_t, CDiskTxPos>>& spends)
+{
+    CDBBatch batch(*this);
+    for (const auto& [outpoint_id, pos] : spends) {
+        batch.Write(DBKey{outpoint_id, pos}, uint8_t{0});
+    }
+    return WriteBatch(batch);
+}
+
+bool TxoSpenderIndex::DB::EraseSpends(const std::vector<std::pair<uint64_t, CDiskTxPos>>& spends)
+{
+    CDBBatch batch(*this);
+    for (const auto& [outpoint_id, pos] : spends) {
+        batch.Erase(DBKey{outpoint_id, pos});
+    }
+    return WriteBatch(batch);
+}
+
+std::vector<CDiskTxPos> TxoSpenderIndex::DB::ReadSpenderPositions(uint64_t outpoint_id)
+{
+    std::vector<CDiskTxPos> positions;
+    std::unique_ptr<CDBIterator> db_it(NewIterator());
+    for (db_it->Seek(DBKeyPrefix{outpoint_id}); db_it->Valid(); db_it->Next()) {
+        DBKey key;
+        if (!db_it->GetKey(key) || key.outpoint_id != outpoint_id) break;
+        positions.push_back(key.pos);
+    }
+    return positions;
+}
+
+TxoSpenderIndex::TxoSpenderIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "txospenderindex"), m_db(std::make_unique<TxoSpenderIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+TxoSpenderIndex::~TxoSpenderIndex() = default;
+
+bool TxoSpenderIndex::CustomInit(const std::optional<interfaces::BlockKey>& block)
+{
+    std::pair<uint64_t, uint64_t> salt;
+    if (!m_db->Read(DB_SALT, salt)) {
+        // Without its salt, the entries of an index that has synced some blocks are lost.
+        if (block || m_db->Exists(DB_SALT)) {
+            return error("%s: Cannot read the salt of %s; index may be corrupted",
+                         __func__, GetName());
+        }
+        salt = {GetRand<uint64_t>(), GetRand<uint64_t>()};
+        if (!m_db->Write(DB_SALT, salt, /*fSync=*/true)) {
+            return error("%s: Failed to write the salt of %s", __func__, GetName());
+        }
+    }
+    std::tie(m_k0, m_k1) = salt;
+    return true;
+}
+
+uint64_t TxoSpenderIndex::OutpointId(const COutPoint& outpoint) const
+{
+    return SipHashUint256Extra(m_k0, m_k1, outpoint.hash, outpoint.n);
+}
+
+std::vector<std::pair<uint64_t, CDiskTxPos>> TxoSpenderIndex::BlockSpends(const CBlock& block, const FlatFilePos& block_pos) const
+{
+    std::vector<std::pair<uint64_t, CDiskTxPos>> spends;
+    CDiskTxPos pos(block_pos, GetSizeOfCompactSize(block.vtx.size()));
+    for (const auto& tx : block.vtx) {
+        if (!tx->IsCoinBase()) {
+            for (const CTxIn& txin : tx->vin) {
+                spends.emplace_back(OutpointId(txin.prevout), pos);
+            }
+        }
+        pos.nTxOffset += ::GetSerializeSize(TX_WITH_WITNESS(*tx));
+    }
+    return spends;
+}
+
+bool TxoSpenderIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    std::any prepared;
+    return CustomPrepare(block, prepared) && CustomAppendPrepared(block, std::move(prepared));
+}
+
+bool TxoSpenderIndex::CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) const
+{
+    // The outputs spent by a block are named by its inputs, so unlike the
+    // indexes built from undo data, this only needs the block itself.
+    prepared = BlockSpends(*Assert(block.data), {block.file_number, block.data_pos});
+    return true;
+}
+
+bool TxoSpenderIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    return m_db->WriteSpends(std::any_cast<const std::vector<std::pair<uint64_t, CDiskTxPos>>&>(prepared));
+}
+
+bool TxoSpenderIndex::CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip)
+{
+    LOCK(cs_main);
+    const CBlockIndex* iter_tip{m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash)};
+    const CBlockIndex* new_tip_index{m_chainstate->m_blockman.LookupBlockIndex(new_tip.hash)};
+
+    do {
+        CBlock block;
+        if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, *iter_tip)) {
+            return error("%s: Failed to read block %s from disk",
+                         __func__, iter_tip->GetBlockHash().ToString());
+        }
+        if (!m_db->EraseSpends(BlockSpends(block, iter_tip->GetBlockPos()))) return false;
+
+        iter_tip = iter_tip->GetAncestor(iter_tip->nHeight - 1);
+    } while (new_tip_index != iter_tip);
+
+    return true;
+}
+
+BaseIndex::DB& TxoSpenderIndex::GetDB() const { return *m_db; }
+
+bool TxoSpenderIndex::ReadTransaction(const CDiskTxPos& pos, CTransactionRef& tx, uint256& block_hash) const
+{
+    AutoFile file{m_chainstate->m_blockman.OpenBlockFile(pos, true)};
+    if (file.IsNull()) {
+        return error("%s: OpenBlockFile failed", __func__);
+    }
+    CBlockHeader header;
+    try {
+        file >> header;
+        if (fseek(file.Get(), pos.nTxOffset, SEEK_CUR)) {
+            return error("%s: fseek(...) failed", __func__);
+        }
+        file >> TX_WITH_WITNESS(tx);
+    } catch (const std::exception& e) {
+        return error("%s: Deserialize or I/O error - %s", __func__, e.what());
+    }
+    block_hash = header.GetHash();
+    return true;
+}
+
+util::Result<std::optional<TxoSpender>> TxoSpenderIndex::FindSpender(const COutPoint& txo) const
+{
+    // Almost always a single position, unless another outpoint has the same id.
+    for (const CDiskTxPos& pos : m_db->ReadSpenderPositions(OutpointId(txo))) {
+        TxoSpender spender;
+        if (!ReadTransaction(pos, spender.tx, spender.block_hash)) {
+            return util::Error{strprintf(Untranslated("Cannot read the transaction spending %s from disk"), txo.ToString())};
+        }
+        for (const CTxIn& txin : spender.tx->vin) {
+            if (txin.prevout == txo) return std::optional{std::move(spender)};
+        }
+    }
+    return std::optional<TxoSpender>{};
+}
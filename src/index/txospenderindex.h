@@ -0,0 +1,91 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_TXOSPENDERINDEX_H
+#define BITCOIN_INDEX_TXOSPENDERINDEX_H
+
+#include <index/base.h>
+#include <index/disktxpos.h>
+#include <primitives/transaction.h>
+#include <uint256.h>
+#include <util/result.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+class CBlock;
+
+static constexpr bool DEFAULT_TXOSPENDERINDEX{false};
+
+/** The transaction spending an output, and the block it is in. */
+struct TxoSpender {
+    CTransactionRef tx;
+    uint256 block_hash;
+};
+
+/**
+ * TxoSpenderIndex is used to look up the transaction which spent a given
+ * output. The index is written to a LevelDB database and records, for each
+ * spent output, the filesystem location of the spending transaction.
+ *
+ * Outputs are keyed by an 8-byte SipHash of the outpoint, salted with a random
+ * key generated when the database is created. Colliding outpoints are told
+ * apart by reading the spending transactions.
+ */
+class TxoSpenderIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    /// The salt of the outpoint ids, read from or written to the database by CustomInit().
+    uint64_t m_k0{0}, m_k1{0};
+
+    bool AllowPrune() const override { return false; }
+
+    /// Compact id of an outpoint in the database.
+    uint64_t OutpointId(const COutPoint& outpoint) const;
+
+    /// Collect the ids of the outputs spent by a block, along with the
+    /// positions of the spending transactions.
+    std::vector<std::pair<uint64_t, CDiskTxPos>> BlockSpends(const CBlock& block, const FlatFilePos& block_pos) const;
+
+    /// Read a transaction and the hash of its block from the block files.
+    bool ReadTransaction(const CDiskTxPos& pos, CTransactionRef& tx, uint256& block_hash) const;
+
+protected:
+    bool CustomInit(const std::optional<interfaces::BlockKey>& block) override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool CustomPrepare(const interfaces::BlockInfo& block, std::any& prepared) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
+    bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit TxoSpenderIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~TxoSpenderIndex() override;
+
+    /// Look up the transaction spending an output.
+    ///
+    /// @param[in]   txo  The output whose spender is to be returned.
+    /// @return  The spender, std::nullopt if the index has none for the output, or
+    ///          an error if a spending transaction could not be read from disk.
+    util::Result<std::optional<TxoSpender>> FindSpender(const COutPoint& txo) const;
+};
+
+/// The global spent output index. May be null.
+extern std::unique_ptr<TxoSpenderIndex> g_txospenderindex;
+
+#endif // BITCOIN_INDEX_TXOSPENDERINDEX_H
@@ -8,12 +8,16 @@
 #include <kernel/notifications_interface.h>
 #include <util/fs.h>
 
+#include <cstddef>
 #include <cstdint>
 
 class CChainParams;
 
 namespace kernel {
 
+static constexpr bool DEFAULT_BLOCKS_MMAP{false};
+static constexpr size_t DEFAULT_BLOCK_CACHE_BYTES{0};
+
 /**
  * An options struct for `BlockManager`, more ergonomically referred to as
  * `BlockManager::Options` due to the using-declaration in `BlockManager`.
@@ -24,6 +28,10 @@ struct BlockManagerOpts {
     bool fast_prune{false};
     const fs::path blocks_dir;
     Notifications& notifications;
+    //! Serve block reads from memory-mapped block files
+    bool use_mmap{DEFAULT_BLOCKS_MMAP};
+    //! Memory limit of the cache of recently read blocks, 0 to disable it
+    size_t block_cache_bytes{DEFAULT_BLOCK_CACHE_BYTES};
 };
 
 } // namespace kernel
@@ -46,6 +46,10 @@ struct ChainstateManagerOpts {
     Notifications& notifications;
     //! Number of script check worker threads. Zero means no parallel verification.
     int worker_threads_num{0};
+    //! Number of threads reading block inputs from disk ahead of connecting the block. Zero means no prefetching.
+    int prefetch_threads_num{0};
+    //! Number of blocks to read from disk and check ahead of connecting them. Zero means no read-ahead.
+    int block_read_ahead{0};
 };
 
 } // namespace kernel
@@ -5,6 +5,7 @@
 #include <kernel/coinstats.h>
 
 #include <chain.h>
+#include <checkqueue.h>
 #include <coins.h>
 #include <crypto/muhash.h>
 #include <hash.h>
@@ -22,16 +23,30 @@
 #include <util/overflow.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cassert>
+#include <exception>
 #include <iosfwd>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace kernel {
 
+/** Number of key ranges the UTXO set is split into to be scanned by several threads */
+static constexpr size_t UTXO_STATS_RANGES{1024};
+/** Number of ranges per thread scanned before they are merged */
+static constexpr size_t UTXO_STATS_RANGES_PER_THREAD{2};
+/** Upper bound on the serialized coins buffered for HASH_SERIALIZED until they
+ * can be hashed in key order, based on the estimated size of the ranges */
+static constexpr size_t UTXO_STATS_MAX_SERIALIZED_BUFFER{128 << 20};
+/** Conservative ratio of the serialized size of coins to their size on disk */
+static constexpr size_t UTXO_STATS_SERIALIZED_PER_STORED{2};
+
 CCoinsStats::CCoinsStats(int block_height, const uint256& block_hash)
     : nHeight(block_height),
       hashBlock(block_hash) {}
@@ -60,6 +75,11 @@ static void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin&
     TxOutSer(ss, outpoint, coin);
 }
 
+static void ApplyCoinHash(DataStream& ss, const COutPoint& outpoint, const Coin& coin)
+{
+    TxOutSer(ss, outpoint, coin);
+}
+
 void ApplyCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin)
 {
     DataStream ss{};
@@ -111,20 +131,17 @@ static void ApplyStats(CCoinsStats& stats, const uint256& hash, const std::map<u
     }
 }
 
-//! Calculate statistics about the unspent transaction output set
+//! Apply the coins of a cursor to the statistics and the hash object
 template <typename T>
-static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
+static bool ApplyCursor(CCoinsViewCursor& cursor, CCoinsStats& stats, T& hash_obj, const std::function<void()>& interruption_point)
 {
-    std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
-    assert(pcursor);
-
     Txid prevkey;
     std::map<uint32_t, Coin> outputs;
-    while (pcursor->Valid()) {
+    while (cursor.Valid()) {
         if (interruption_point) interruption_point();
         COutPoint key;
         Coin coin;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
+        if (cursor.GetKey(key) && cursor.GetValue(coin)) {
             if (!outputs.empty() && key.hash != prevkey) {
                 ApplyStats(stats, prevkey, outputs);
                 ApplyHash(hash_obj, prevkey, outputs);
@@ -136,12 +153,102 @@ static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, c
         } else {
             return error("%s: unable to read value", __func__);
         }
-        pcursor->Next();
+        cursor.Next();
     }
     if (!outputs.empty()) {
         ApplyStats(stats, prevkey, outputs);
         ApplyHash(hash_obj, prevkey, outputs);
     }
+    return true;
+}
+
+//! The serialized coins of a range are buffered to be fed to the HashWriter in
+//! key order, while the other hash objects can be combined in any order.
+template <typename T>
+using RangeHashType = std::conditional_t<std::is_same_v<T, HashWriter>, DataStream, T>;
+
+static void MergeHash(HashWriter& ss, const DataStream& range) { ss.write(MakeByteSpan(range)); }
+static void MergeHash(MuHash3072& muhash, const MuHash3072& range) { muhash *= range; }
+static void MergeHash(std::nullptr_t, std::nullptr_t) {}
+
+static void MergeStats(CCoinsStats& stats, const CCoinsStats& range)
+{
+    stats.nTransactions += range.nTransactions;
+    stats.nTransactionOutputs += range.nTransactionOutputs;
+    stats.nBogoSize += range.nBogoSize;
+    stats.coins_count += range.coins_count;
+    if (stats.total_amount.has_value() && range.total_amount.has_value()) {
+        stats.total_amount = CheckedAdd(*stats.total_amount, *range.total_amount);
+    } else {
+        stats.total_amount = std::nullopt;
+    }
+}
+
+//! Set the block the statistics are for to the one the coins were read at
+static void SetBestBlock(CCoinsStats& stats, node::BlockManager& blockman, const uint256& best_block)
+{
+    const CBlockIndex* pindex{WITH_LOCK(::cs_main, return blockman.LookupBlockIndex(best_block))};
+    stats.nHeight = Assert(pindex)->nHeight;
+    stats.hashBlock = pindex->GetBlockHash();
+}
+
+//! Calculate statistics about the unspent transaction output set on the
+//! calling thread and worker_threads_num additional ones
+template <typename T>
+static bool ComputeUTXOStats(CCoinsView* view, node::BlockManager& blockman, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point, int worker_threads_num)
+{
+    if (worker_threads_num <= 0) {
+        std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
+        assert(pcursor);
+        SetBestBlock(stats, blockman, pcursor->GetBestBlock());
+        if (!ApplyCursor(*pcursor, stats, hash_obj, interruption_point)) return false;
+    } else {
+        std::vector<std::unique_ptr<CCoinsViewCursor>> cursors{view->RangeCursors(UTXO_STATS_RANGES)};
+        assert(!cursors.empty());
+        SetBestBlock(stats, blockman, cursors.front()->GetBestBlock());
+
+        CCheckQueue<std::function<bool()>> queue{/*batch_size=*/1, worker_threads_num, "utxostats"};
+        // The interruption point may throw, which must not happen on a worker
+        // thread. The exception is passed on to this thread instead.
+        Mutex exception_mutex;
+        std::exception_ptr exception;
+
+        // Ranges are scanned a window at a time and merged in key order. For
+        // HASH_SERIALIZED the window is also limited by the estimated size of
+        // the serialized coins it buffers.
+        size_t window_size{size_t(worker_threads_num + 1) * UTXO_STATS_RANGES_PER_THREAD};
+        if constexpr (std::is_same_v<T, HashWriter>) {
+            const size_t range_size{UTXO_STATS_SERIALIZED_PER_STORED * view->EstimateSize() / cursors.size()};
+            window_size = std::clamp<size_t>(UTXO_STATS_MAX_SERIALIZED_BUFFER / std::max<size_t>(range_size, 1), 1, window_size);
+        }
+        for (size_t begin = 0; begin < cursors.size(); begin += window_size) {
+            const size_t end{std::min(begin + window_size, cursors.size())};
+            std::vector<CCoinsStats> range_stats(end - begin);
+            std::vector<RangeHashType<T>> range_hashes(end - begin);
+
+            CCheckQueueControl<std::function<bool()>> control(&queue);
+            for (size_t n = begin; n < end; ++n) {
+                control.Add({[&, n] {
+                    try {
+                        return ApplyCursor(*cursors[n], range_stats[n - begin], range_hashes[n - begin], interruption_point);
+                    } catch (...) {
+                        LOCK(exception_mutex);
+                        if (!exception) exception = std::current_exception();
+                        return false;
+                    }
+                }});
+            }
+            const bool success{control.Wait()};
+            if (exception) std::rethrow_exception(exception);
+            if (!success) return false;
+
+            for (size_t n = begin; n < end; ++n) {
+                MergeStats(stats, range_stats[n - begin]);
+                MergeHash(hash_obj, range_hashes[n - begin]);
+                cursors[n].reset();
+            }
+        }
+    }
 
     FinalizeHash(hash_obj, stats);
 
@@ -150,23 +257,22 @@ static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, c
     return true;
 }
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point)
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point, int worker_threads_num)
 {
-    CBlockIndex* pindex = WITH_LOCK(::cs_main, return blockman.LookupBlockIndex(view->GetBestBlock()));
-    CCoinsStats stats{Assert(pindex)->nHeight, pindex->GetBlockHash()};
+    CCoinsStats stats{};
 
     bool success = [&]() -> bool {
         switch (hash_type) {
         case(CoinStatsHashType::HASH_SERIALIZED): {
             HashWriter ss{};
-            return ComputeUTXOStats(view, stats, ss, interruption_point);
+            return ComputeUTXOStats(view, blockman, stats, ss, interruption_point, worker_threads_num);
         }
         case(CoinStatsHashType::MUHASH): {
             MuHash3072 muhash;
-            return ComputeUTXOStats(view, stats, muhash, interruption_point);
+            return ComputeUTXOStats(view, blockman, stats, muhash, interruption_point, worker_threads_num);
         }
         case(CoinStatsHashType::NONE): {
-            return ComputeUTXOStats(view, stats, nullptr, interruption_point);
+            return ComputeUTXOStats(view, blockman, stats, nullptr, interruption_point, worker_threads_num);
         }
         } // no default case, so the compiler can warn about missing cases
         assert(false);
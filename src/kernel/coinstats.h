@@ -76,7 +76,16 @@ uint64_t GetBogoSize(const CScript& script_pub_key);
 void ApplyCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {});
+/**
+ * Calculate statistics about the unspent transaction output set of a view.
+ *
+ * With worker_threads_num above zero, the set is split into key ranges that are
+ * scanned by the calling thread and that many additional ones, and merged in
+ * key order, with the same result as a scan on a single thread. The
+ * interruption point is then called from all of these threads, and an
+ * exception it throws is rethrown on the calling thread.
+ */
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {}, int worker_threads_num = 0);
 } // namespace kernel
 
 #endif // BITCOIN_KERNEL_COINSTATS_H
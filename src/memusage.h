@@ -5,6 +5,7 @@
 #ifndef BITCOIN_MEMUSAGE_H
 #define BITCOIN_MEMUSAGE_H
 
+#include <flathashmap.h>
 #include <indirectmap.h>
 #include <prevector.h>
 #include <support/allocators/pool.h>
@@ -202,6 +203,14 @@ static inline size_t DynamicUsage(const std::unordered_map<Key,
     return usage_resource + usage_chunks + MallocUsage(sizeof(void*) * m.bucket_count());
 }
 
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+static inline size_t DynamicUsage(const FlatHashMap<Key, T, Hash, KeyEqual>& m)
+{
+    // One slot and one control byte per entry of capacity, in two allocations.
+    if (m.capacity() == 0) return 0;
+    return MallocUsage(sizeof(std::pair<const Key, T>) * m.capacity()) + MallocUsage(m.capacity());
+}
+
 } // namespace memusage
 
 #endif // BITCOIN_MEMUSAGE_H
@@ -123,7 +123,11 @@ size_t CSerializedNetMsg::GetMemoryUsage() const noexcept
     // Don't count the dynamic memory used for the m_type string, by assuming it fits in the
     // "small string" optimization area (which stores data inside the object itself, up to some
     // size; 15 bytes in modern libstdc++).
-    return sizeof(*this) + memusage::DynamicUsage(data);
+    // A shared payload is counted in full for every message holding it, so that the send
+    // buffer limits of the peers behave the same as with a copy each.
+    size_t usage{sizeof(*this) + memusage::DynamicUsage(data)};
+    if (m_shared_data) usage += memusage::DynamicUsage(m_shared_data) + memusage::DynamicUsage(*m_shared_data);
+    return usage;
 }
 
 void CConnman::AddAddrFetch(const std::string& strDest)
@@ -803,65 +807,112 @@ CNetMessage V1Transport::GetReceivedMessage(const std::chrono::microseconds time
     return msg;
 }
 
+bool Transport::GetBytesToSendMany(bool have_next_message, size_t max_spans, std::vector<SendSpan>& spans) const noexcept
+{
+    Assume(max_spans > 0);
+    const auto& [data, more, msg_type] = GetBytesToSend(have_next_message);
+    if (!data.empty()) spans.push_back({data, msg_type});
+    return more;
+}
+
 bool V1Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
 {
     AssertLockNotHeld(m_send_mutex);
     // Determine whether a new message can be set.
     LOCK(m_send_mutex);
-    if (m_sending_header || m_bytes_sent < m_message_to_send.data.size()) return false;
+    if (m_send_queue.size() >= MAX_QUEUED_MESSAGES) return false;
 
     // create dbl-sha256 checksum
-    uint256 hash = Hash(msg.data);
+    uint256 hash = Hash(msg.Payload());
 
     // create header
-    CMessageHeader hdr(m_magic_bytes, msg.m_type.c_str(), msg.data.size());
+    CMessageHeader hdr(m_magic_bytes, msg.m_type.c_str(), msg.Payload().size());
     memcpy(hdr.pchChecksum, hash.begin(), CMessageHeader::CHECKSUM_SIZE);
 
     // serialize header
-    m_header_to_send.clear();
-    VectorWriter{m_header_to_send, 0, hdr};
+    std::vector<uint8_t> header;
+    VectorWriter{header, 0, hdr};
 
     // update state
-    m_message_to_send = std::move(msg);
-    m_sending_header = true;
-    m_bytes_sent = 0;
+    if (m_send_queue.empty()) {
+        m_sending_header = true;
+        m_bytes_sent = 0;
+    }
+    m_send_queue.push_back({std::move(header), std::move(msg)});
     return true;
 }
 
 Transport::BytesToSend V1Transport::GetBytesToSend(bool have_next_message) const noexcept
 {
+    static const std::string no_msg_type;
+
     AssertLockNotHeld(m_send_mutex);
     LOCK(m_send_mutex);
+    if (m_send_queue.empty()) return {{}, have_next_message, no_msg_type};
+    const SendEntry& entry{m_send_queue.front()};
     if (m_sending_header) {
-        return {Span{m_header_to_send}.subspan(m_bytes_sent),
+        return {Span{entry.header}.subspan(m_bytes_sent),
                 // We have more to send after the header if the message has payload, or if there
                 // is a next message after that.
-                have_next_message || !m_message_to_send.data.empty(),
-                m_message_to_send.m_type
+                have_next_message || !entry.msg.Payload().empty() || m_send_queue.size() > 1,
+                entry.msg.m_type
                };
     } else {
-        return {Span{m_message_to_send.data}.subspan(m_bytes_sent),
+        return {entry.msg.Payload().subspan(m_bytes_sent),
                 // We only have more to send after this message's payload if there is another
                 // message.
-                have_next_message,
-                m_message_to_send.m_type
+                have_next_message || m_send_queue.size() > 1,
+                entry.msg.m_type
                };
     }
 }
 
+bool V1Transport::GetBytesToSendMany(bool have_next_message, size_t max_spans, std::vector<SendSpan>& spans) const noexcept
+{
+    AssertLockNotHeld(m_send_mutex);
+    LOCK(m_send_mutex);
+    Assume(max_spans > 0);
+    size_t added{0};
+    bool sending_header{m_sending_header};
+    size_t bytes_sent{m_bytes_sent};
+    for (auto it{m_send_queue.begin()}; it != m_send_queue.end();) {
+        const Span<const uint8_t> data{sending_header ? Span{it->header} : it->msg.Payload()};
+        if (bytes_sent < data.size()) {
+            if (added == max_spans) return true;
+            spans.push_back({data.subspan(bytes_sent), it->msg.m_type});
+            ++added;
+        }
+        bytes_sent = 0;
+        if (sending_header) {
+            sending_header = false;
+        } else {
+            sending_header = true;
+            ++it;
+        }
+    }
+    return have_next_message;
+}
+
 void V1Transport::MarkBytesSent(size_t bytes_sent) noexcept
 {
     AssertLockNotHeld(m_send_mutex);
     LOCK(m_send_mutex);
-    m_bytes_sent += bytes_sent;
-    if (m_sending_header && m_bytes_sent == m_header_to_send.size()) {
-        // We're done sending a message's header. Switch to sending its data bytes.
-        m_sending_header = false;
-        m_bytes_sent = 0;
-    } else if (!m_sending_header && m_bytes_sent == m_message_to_send.data.size()) {
-        // We're done sending a message's data. Wipe the data vector to reduce memory consumption.
-        ClearShrink(m_message_to_send.data);
+    while (bytes_sent > 0 && !m_send_queue.empty()) {
+        const SendEntry& entry{m_send_queue.front()};
+        const size_t size{m_sending_header ? entry.header.size() : entry.msg.Payload().size()};
+        const size_t sent_now{std::min(bytes_sent, size - m_bytes_sent)};
+        m_bytes_sent += sent_now;
+        bytes_sent -= sent_now;
+        if (m_bytes_sent < size) break;
         m_bytes_sent = 0;
+        if (m_sending_header && !entry.msg.Payload().empty()) {
+            // We're done sending a message's header. Switch to sending its data bytes.
+            m_sending_header = false;
+        } else {
+            // We're done sending a message. Drop it to reduce memory consumption.
+            m_send_queue.pop_front();
+            m_sending_header = !m_send_queue.empty();
+        }
     }
 }
 
@@ -869,8 +920,10 @@ size_t V1Transport::GetSendMemoryUsage() const noexcept
 {
     AssertLockNotHeld(m_send_mutex);
     LOCK(m_send_mutex);
-    // Don't count sending-side fields besides m_message_to_send, as they're all small and bounded.
-    return m_message_to_send.GetMemoryUsage();
+    // Don't count sending-side fields besides the queued messages, as they're all small and bounded.
+    size_t usage{0};
+    for (const SendEntry& entry : m_send_queue) usage += entry.msg.GetMemoryUsage();
+    return usage;
 }
 
 namespace {
@@ -1454,17 +1507,18 @@ bool V2Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
     if (!(m_send_state == SendState::READY && m_send_buffer.empty())) return false;
     // Construct contents (encoding message type + payload).
     std::vector<uint8_t> contents;
+    const auto payload{msg.Payload()};
     auto short_message_id = V2_MESSAGE_MAP(msg.m_type);
     if (short_message_id) {
-        contents.resize(1 + msg.data.size());
+        contents.resize(1 + payload.size());
         contents[0] = *short_message_id;
-        std::copy(msg.data.begin(), msg.data.end(), contents.begin() + 1);
+        std::copy(payload.begin(), payload.end(), contents.begin() + 1);
     } else {
         // Initialize with zeroes, and then write the message type string starting at offset 1.
         // This means contents[0] and the unused positions in contents[1..13] remain 0x00.
-        contents.resize(1 + CMessageHeader::COMMAND_SIZE + msg.data.size(), 0);
+        contents.resize(1 + CMessageHeader::COMMAND_SIZE + payload.size(), 0);
         std::copy(msg.m_type.begin(), msg.m_type.end(), contents.data() + 1);
-        std::copy(msg.data.begin(), msg.data.end(), contents.begin() + 1 + CMessageHeader::COMMAND_SIZE);
+        std::copy(payload.begin(), payload.end(), contents.begin() + 1 + CMessageHeader::COMMAND_SIZE);
     }
     // Construct ciphertext in send buffer.
     m_send_buffer.resize(contents.size() + BIP324Cipher::EXPANSION);
@@ -1472,6 +1526,7 @@ bool V2Transport::SetMessageToSend(CSerializedNetMsg& msg) noexcept
     m_send_type = msg.m_type;
     // Release memory
     ClearShrink(msg.data);
+    msg.m_shared_data.reset();
     return true;
 }
 
@@ -1492,6 +1547,16 @@ Transport::BytesToSend V2Transport::GetBytesToSend(bool have_next_message) const
     };
 }
 
+bool V2Transport::GetBytesToSendMany(bool have_next_message, size_t max_spans, std::vector<SendSpan>& spans) const noexcept
+{
+    AssertLockNotHeld(m_send_mutex);
+    if (WITH_LOCK(m_send_mutex, return m_send_state == SendState::V1)) {
+        return m_v1_fallback.GetBytesToSendMany(have_next_message, max_spans, spans);
+    }
+    // A V2 packet is encrypted in one piece, there is nothing to add after it.
+    return Transport::GetBytesToSendMany(have_next_message, max_spans, spans);
+}
+
 void V2Transport::MarkBytesSent(size_t bytes_sent) noexcept
 {
     AssertLockNotHeld(m_send_mutex);
@@ -1568,27 +1633,32 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
     bool data_left{false}; //!< second return value (whether unsent data remains)
     std::optional<bool> expected_more;
 
+    std::vector<Transport::SendSpan> spans;
+    std::vector<Span<const unsigned char>> buffers;
+
     while (true) {
-        if (it != node.vSendMsg.end()) {
-            // If possible, move one message from the send queue to the transport. This fails when
-            // there is an existing message still being sent, or (for v2 transports) when the
-            // handshake has not yet completed.
+        // Move as many messages from the send queue to the transport as it will accept. This
+        // stops when the transport's own queue is full, or (for v2 transports) when the
+        // handshake has not yet completed.
+        while (it != node.vSendMsg.end()) {
             size_t memusage = it->GetMemoryUsage();
-            if (node.m_transport->SetMessageToSend(*it)) {
-                // Update memory usage of send buffer (as *it will be deleted).
-                node.m_send_memusage -= memusage;
-                ++it;
-            }
-        }
-        const auto& [data, more, msg_type] = node.m_transport->GetBytesToSend(it != node.vSendMsg.end());
-        // We rely on the 'more' value returned by GetBytesToSend to correctly predict whether more
-        // bytes are still to be sent, to correctly set the MSG_MORE flag. As a sanity check,
+            if (!node.m_transport->SetMessageToSend(*it)) break;
+            // Update memory usage of send buffer (as *it will be deleted).
+            node.m_send_memusage -= memusage;
+            ++it;
+        }
+        spans.clear();
+        const bool more{node.m_transport->GetBytesToSendMany(it != node.vSendMsg.end(), MAX_SEND_SPANS, spans)};
+        // We rely on the 'more' value returned by GetBytesToSendMany to correctly predict whether
+        // more bytes are still to be sent, to correctly set the MSG_MORE flag. As a sanity check,
         // verify that the previously returned 'more' was correct.
-        if (expected_more.has_value()) Assume(!data.empty() == *expected_more);
+        if (expected_more.has_value()) Assume(!spans.empty() == *expected_more);
         expected_more = more;
-        data_left = !data.empty(); // will be overwritten on next loop if all of data gets sent
-        int nBytes = 0;
-        if (!data.empty()) {
+        data_left = !spans.empty(); // will be overwritten on next loop if all of data gets sent
+        size_t total{0};
+        for (const auto& span : spans) total += span.data.size();
+        ssize_t nBytes = 0;
+        if (!spans.empty()) {
             LOCK(node.m_sock_mutex);
             // There is no socket in case we've already disconnected, or in test cases without
             // real connections. In these cases, we bail out immediately and just leave things
@@ -1602,20 +1672,34 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
                 flags |= MSG_MORE;
             }
 #endif
-            nBytes = node.m_sock->Send(reinterpret_cast<const char*>(data.data()), data.size(), flags);
+            if (spans.size() == 1) {
+                nBytes = node.m_sock->Send(reinterpret_cast<const char*>(spans[0].data.data()), spans[0].data.size(), flags);
+            } else {
+                // Hand all queued chunks to the kernel in a single system call.
+                buffers.clear();
+                for (const auto& span : spans) buffers.push_back(span.data);
+                nBytes = node.m_sock->SendMany(buffers, flags);
+            }
         }
         if (nBytes > 0) {
             node.m_last_send = GetTime<std::chrono::seconds>();
             node.nSendBytes += nBytes;
+            // Update statistics per message type. This has to happen before MarkBytesSent, which
+            // may release the messages the spans point into.
+            size_t remaining = nBytes;
+            for (const auto& span : spans) {
+                if (remaining == 0) break;
+                const size_t sent{std::min(remaining, span.data.size())};
+                if (!span.m_type.empty()) { // don't report v2 handshake bytes for now
+                    node.AccountForSentBytes(span.m_type, sent);
+                }
+                remaining -= sent;
+            }
             // Notify transport that bytes have been processed.
             node.m_transport->MarkBytesSent(nBytes);
-            // Update statistics per message type.
-            if (!msg_type.empty()) { // don't report v2 handshake bytes for now
-                node.AccountForSentBytes(msg_type, nBytes);
-            }
             nSentSize += nBytes;
-            if ((size_t)nBytes != data.size()) {
-                // could not send full message; stop sending more
+            if ((size_t)nBytes != total) {
+                // could not send all data; stop sending more
                 break;
             }
         } else {
@@ -2042,7 +2126,7 @@ void CConnman::SocketHandler()
         // select(2)). If none are ready, wait for a short while and return
         // empty sets.
         events_per_sock = GenerateWaitSockets(snap.Nodes());
-        if (events_per_sock.empty() || !events_per_sock.begin()->first->WaitMany(timeout, events_per_sock)) {
+        if (!m_sock_wait_set.WaitMany(timeout, events_per_sock)) {
             interruptNet.sleep_for(timeout);
         }
 
@@ -3751,10 +3835,10 @@ bool CConnman::NodeFullyConnected(const CNode* pnode)
 void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
 {
     AssertLockNotHeld(m_total_bytes_sent_mutex);
-    size_t nMessageSize = msg.data.size();
+    size_t nMessageSize = msg.Payload().size();
     LogPrint(BCLog::NET, "sending %s (%d bytes) peer=%d\n", msg.m_type, nMessageSize, pnode->GetId());
     if (gArgs.GetBoolArg("-capturemessages", false)) {
-        CaptureMessage(pnode->addr, msg.m_type, msg.data, /*is_incoming=*/false);
+        CaptureMessage(pnode->addr, msg.m_type, msg.Payload(), /*is_incoming=*/false);
     }
 
     TRACE6(net, outbound_message,
@@ -3762,8 +3846,8 @@ void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
         pnode->m_addr_name.c_str(),
         pnode->ConnectionTypeAsString().c_str(),
         msg.m_type.c_str(),
-        msg.data.size(),
-        msg.data.data()
+        msg.Payload().size(),
+        msg.Payload().data()
     );
 
     size_t nBytesSent = 0;
@@ -66,6 +66,8 @@ static constexpr auto FEELER_INTERVAL = 2min;
 static constexpr auto EXTRA_BLOCK_RELAY_ONLY_PEER_INTERVAL = 5min;
 /** Maximum length of incoming protocol messages (no message over 4 MB is currently acceptable). */
 static const unsigned int MAX_PROTOCOL_MESSAGE_LENGTH = 4 * 1000 * 1000;
+/** Maximum number of buffers handed to a single vectored send call (well below IOV_MAX). */
+static constexpr size_t MAX_SEND_SPANS{64};
 /** Maximum length of the user agent string in `version` message */
 static const unsigned int MAX_SUBVERSION_LENGTH = 256;
 /** Maximum number of automatic outgoing nodes over which we'll relay everything (blocks, tx, addrs, etc) */
@@ -128,11 +130,28 @@ struct CSerializedNetMsg {
     {
         CSerializedNetMsg copy;
         copy.data = data;
+        copy.m_shared_data = m_shared_data;
         copy.m_type = m_type;
         return copy;
     }
 
+    /**
+     * Move the payload into a buffer that is shared by the copies of this
+     * message, so that sending it to many peers serializes and stores it once.
+     */
+    void SharePayload()
+    {
+        if (m_shared_data) return;
+        m_shared_data = std::make_shared<const std::vector<unsigned char>>(std::move(data));
+        data.clear();
+    }
+
+    /** The payload, which is either data or the shared buffer. */
+    Span<const unsigned char> Payload() const noexcept { return m_shared_data ? Span{*m_shared_data} : Span{data}; }
+
     std::vector<unsigned char> data;
+    //! Payload shared with other messages, used instead of data when set
+    std::shared_ptr<const std::vector<unsigned char>> m_shared_data;
     std::string m_type;
 
     /** Compute total memory usage of this object (own memory + any dynamic memory). */
@@ -351,9 +370,29 @@ public:
      */
     virtual BytesToSend GetBytesToSend(bool have_next_message) const noexcept = 0;
 
+    /** A span of bytes to send on the wire, and the message type it is sent on behalf of. */
+    struct SendSpan {
+        Span<const uint8_t> data;
+        const std::string& m_type;
+    };
+
+    /** Get the bytes GetBytesToSend() returns, followed by the bytes it would return once those
+     * are sent, so that they can be written to the socket with a single call.
+     *
+     * @param[in]  have_next_message  As for GetBytesToSend().
+     * @param[in]  max_spans          Maximum number of spans to append, at least 1.
+     * @param[out] spans              Appended with the non-empty spans of bytes to send, in order.
+     *                                Like to_send of GetBytesToSend(), they refer to data internal
+     *                                to the transport.
+     * @return whether more bytes will be sendable after all bytes in spans are sent, with the
+     *         meaning of 'more' in GetBytesToSend().
+     */
+    virtual bool GetBytesToSendMany(bool have_next_message, size_t max_spans, std::vector<SendSpan>& spans) const noexcept;
+
     /** Report how many bytes returned by the last GetBytesToSend() have been sent.
      *
-     * bytes_sent cannot exceed to_send.size() of the last GetBytesToSend() result.
+     * bytes_sent cannot exceed to_send.size() of the last GetBytesToSend() result, or the total
+     * size of the spans of the last GetBytesToSendMany() call.
      *
      * If bytes_sent=0, this call has no effect.
      */
@@ -406,18 +445,26 @@ private:
         return hdr.nMessageSize == nDataPos;
     }
 
+    /** A message to send, with its serialized header. */
+    struct SendEntry {
+        std::vector<uint8_t> header;
+        CSerializedNetMsg msg;
+    };
+
     /** Lock for sending state. */
     mutable Mutex m_send_mutex;
-    /** The header of the message currently being sent. */
-    std::vector<uint8_t> m_header_to_send GUARDED_BY(m_send_mutex);
-    /** The data of the message currently being sent. */
-    CSerializedNetMsg m_message_to_send GUARDED_BY(m_send_mutex);
-    /** Whether we're currently sending header bytes or message bytes. */
+    /** The messages to send. The front one is the one currently being sent. */
+    std::deque<SendEntry> m_send_queue GUARDED_BY(m_send_mutex);
+    /** Whether we're currently sending header bytes or message bytes of the front message. */
     bool m_sending_header GUARDED_BY(m_send_mutex) {false};
-    /** How many bytes have been sent so far (from m_header_to_send, or from m_message_to_send.data). */
+    /** How many bytes of the front message have been sent so far (from its header, or from its payload). */
     size_t m_bytes_sent GUARDED_BY(m_send_mutex) {0};
 
 public:
+    /** Maximum number of messages accepted by SetMessageToSend() before the first of them is sent,
+     *  so that a burst of small messages can be written to the socket at once. */
+    static constexpr size_t MAX_QUEUED_MESSAGES{64};
+
     explicit V1Transport(const NodeId node_id) noexcept;
 
     bool ReceivedMessageComplete() const override EXCLUSIVE_LOCKS_REQUIRED(!m_recv_mutex)
@@ -445,6 +492,7 @@ public:
 
     bool SetMessageToSend(CSerializedNetMsg& msg) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     BytesToSend GetBytesToSend(bool have_next_message) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
+    bool GetBytesToSendMany(bool have_next_message, size_t max_spans, std::vector<SendSpan>& spans) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     void MarkBytesSent(size_t bytes_sent) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     size_t GetSendMemoryUsage() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     bool ShouldReconnectV1() const noexcept override { return false; }
@@ -655,6 +703,7 @@ public:
     // Send side functions.
     bool SetMessageToSend(CSerializedNetMsg& msg) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     BytesToSend GetBytesToSend(bool have_next_message) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
+    bool GetBytesToSendMany(bool have_next_message, size_t max_spans, std::vector<SendSpan>& spans) const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     void MarkBytesSent(size_t bytes_sent) noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
     size_t GetSendMemoryUsage() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_send_mutex);
 
@@ -1527,6 +1576,12 @@ private:
      */
     std::unique_ptr<i2p::sam::Session> m_i2p_sam_session;
 
+    /**
+     * Sockets waited on by `SocketHandler()`, kept registered with the kernel
+     * between iterations. Only used by `threadSocketHandler`.
+     */
+    SockWaitSet m_sock_wait_set;
+
     std::thread threadDNSAddressSeed;
     std::thread threadSocketHandler;
     std::thread threadOpenAddedConnections;
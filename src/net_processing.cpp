@@ -10,8 +10,10 @@
 #include <blockencodings.h>
 #include <blockfilter.h>
 #include <chainparams.h>
+#include <checkqueue.h>
 #include <consensus/amount.h>
 #include <consensus/validation.h>
+#include <crypto/sha256.h>
 #include <deploymentstatus.h>
 #include <hash.h>
 #include <headerssync.h>
@@ -41,17 +43,22 @@
 #include <txrequest.h>
 #include <util/check.h>
 #include <util/strencodings.h>
+#include <util/thread.h>
 #include <util/time.h>
 #include <util/trace.h>
 #include <validation.h>
 
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <future>
 #include <memory>
 #include <optional>
+#include <thread>
 #include <typeinfo>
 #include <utility>
+#include <vector>
 
 /** Headers download timeout.
  *  Timeout = base + per_header * (expected number of headers) */
@@ -189,6 +196,50 @@ struct QueuedBlock {
     std::unique_ptr<PartiallyDownloadedBlock> partialBlock;
 };
 
+/** Minimum number of bytes worth handing to an extra thread in HashBatchParallel. */
+constexpr size_t MIN_PARALLEL_HASH_BYTES{256 * 1024};
+
+/** A slice of a batch of messages to double-SHA256 on the block hashing threads. */
+struct BlockHashJob {
+    unsigned char* out;
+    const unsigned char* const* in;
+    const size_t* lengths;
+    size_t count;
+
+    bool operator()()
+    {
+        SHA256DMany(out, in, lengths, count);
+        return true;
+    }
+};
+
+/** Double-SHA256 a batch of messages like SHA256DMany, splitting it into slices of about equal
+ *  byte size for the calling thread and the worker threads of queue. */
+void HashBatchParallel(unsigned char* out, const unsigned char* const* in, const size_t* lengths, size_t count, CCheckQueue<BlockHashJob>* queue, int extra_threads)
+{
+    size_t total{0};
+    for (size_t i = 0; i < count; ++i) total += lengths[i];
+    const size_t slices{queue ? std::clamp<size_t>(total / MIN_PARALLEL_HASH_BYTES, 1, size_t(extra_threads) + 1) : 1};
+    if (slices == 1) {
+        SHA256DMany(out, in, lengths, count);
+        return;
+    }
+
+    std::vector<BlockHashJob> jobs;
+    jobs.reserve(slices);
+    size_t begin{0}, hashed{0};
+    for (size_t slice = 1; slice <= slices; ++slice) {
+        size_t end{begin};
+        while (end < count && (slice == slices || hashed < total * slice / slices)) hashed += lengths[end++];
+        jobs.push_back({out + 32 * begin, in + begin, lengths + begin, end - begin});
+        begin = end;
+    }
+    // The calling thread takes part in the hashing while it waits.
+    CCheckQueueControl<BlockHashJob> control{queue};
+    control.Add(std::move(jobs));
+    control.Wait();
+}
+
 /**
  * Data structure for an individual peer. This struct is not protected by
  * cs_main since it does not contain validation-critical data.
@@ -368,6 +419,10 @@ struct Peer {
     Mutex m_getdata_requests_mutex;
     /** Work queue of items requested by this peer **/
     std::deque<CInv> m_getdata_requests GUARDED_BY(m_getdata_requests_mutex);
+    /** Whether a block requested by this peer is being served by a getdata
+     *  thread. Until it is done, no further getdata requests or messages of
+     *  this peer are processed, so that our responses keep their order. **/
+    std::atomic<bool> m_getdata_in_flight{false};
 
     /** Time of the last getheaders message to this peer */
     NodeClock::time_point m_last_getheaders_timestamp GUARDED_BY(NetEventsInterface::g_msgproc_mutex){};
@@ -485,6 +540,7 @@ public:
     PeerManagerImpl(CConnman& connman, AddrMan& addrman,
                     BanMan* banman, ChainstateManager& chainman,
                     CTxMemPool& pool, Options opts);
+    ~PeerManagerImpl() override EXCLUSIVE_LOCKS_REQUIRED(!m_getdata_jobs_mutex);
 
     /** Overridden from CValidationInterface. */
     void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexConnected) override
@@ -500,7 +556,7 @@ public:
 
     /** Implement NetEventsInterface */
     void InitializeNode(CNode& node, ServiceFlags our_services) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
-    void FinalizeNode(const CNode& node) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_headers_presync_mutex);
+    void FinalizeNode(const CNode& node) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_headers_presync_mutex, !m_getdata_jobs_mutex);
     bool HasAllDesirableServiceFlags(ServiceFlags services) const override;
     bool ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_recent_confirmed_transactions_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex);
@@ -864,9 +920,21 @@ private:
     Mutex m_most_recent_block_mutex;
     std::shared_ptr<const CBlock> m_most_recent_block GUARDED_BY(m_most_recent_block_mutex);
     std::shared_ptr<const CBlockHeaderAndShortTxIDs> m_most_recent_compact_block GUARDED_BY(m_most_recent_block_mutex);
+    /** cmpctblock message of m_most_recent_compact_block, serialized when first needed. Its payload
+     *  is shared by all copies sent. Call get() without holding m_most_recent_block_mutex. */
+    std::shared_future<CSerializedNetMsg> m_most_recent_compact_block_msg GUARDED_BY(m_most_recent_block_mutex);
+    /** Witness block message of m_most_recent_block, built when it is first requested */
+    std::optional<CSerializedNetMsg> m_most_recent_block_msg GUARDED_BY(m_most_recent_block_mutex);
     uint256 m_most_recent_block_hash GUARDED_BY(m_most_recent_block_mutex);
     std::unique_ptr<const std::map<uint256, CTransactionRef>> m_most_recent_block_txs GUARDED_BY(m_most_recent_block_mutex);
 
+    /**
+     * Copy of the witness block message of `block` if it is still the most
+     * recent block, sharing its payload with the copies sent to other peers.
+     */
+    std::optional<CSerializedNetMsg> MostRecentBlockMsg(const std::shared_ptr<const CBlock>& block)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex);
+
     // Data about the low-work headers synchronization, aggregated from all peers' HeadersSyncStates.
     /** Mutex guarding the other m_headers_presync_* variables. */
     Mutex m_headers_presync_mutex;
@@ -960,7 +1028,7 @@ private:
         EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex, NetEventsInterface::g_msgproc_mutex);
 
     void ProcessGetData(CNode& pfrom, Peer& peer, const std::atomic<bool>& interruptMsgProc)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex, peer.m_getdata_requests_mutex, NetEventsInterface::g_msgproc_mutex)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_getdata_jobs_mutex, peer.m_getdata_requests_mutex, NetEventsInterface::g_msgproc_mutex)
         LOCKS_EXCLUDED(::cs_main);
 
     /** Process a new block. Perform any post-processing housekeeping */
@@ -1017,7 +1085,32 @@ private:
     bool BlockRequestAllowed(const CBlockIndex* pindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     bool AlreadyHaveBlock(const uint256& block_hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     void ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv& inv)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_getdata_jobs_mutex);
+
+    /** A block request handed to the getdata threads by ProcessGetBlockData() */
+    struct GetDataJob {
+        //! Not used anymore once peer->m_getdata_in_flight is reset, FinalizeNode() waits for that
+        CNode* node{nullptr};
+        PeerRef peer;
+        CInv inv;
+        FlatFilePos pos;
+        //! Tip to announce after the block if it is the peer's continuation block
+        std::optional<uint256> continuation_tip;
+    };
+
+    Mutex m_getdata_jobs_mutex;
+    std::condition_variable m_getdata_jobs_cv;
+    std::deque<GetDataJob> m_getdata_jobs GUARDED_BY(m_getdata_jobs_mutex);
+    bool m_getdata_stop GUARDED_BY(m_getdata_jobs_mutex){false};
+    std::vector<std::thread> m_getdata_threads;
+
+    /** Worker threads hashing the transactions of blocks received from peers, if
+     *  Options::block_hash_threads is set. Only used by the message handler thread. */
+    std::unique_ptr<CCheckQueue<BlockHashJob>> m_block_hash_queue;
+
+    void ThreadGetData() EXCLUSIVE_LOCKS_REQUIRED(!m_getdata_jobs_mutex);
+    /** Read the block of a job from disk and send it to the peer */
+    void ServeBlockFromDisk(const GetDataJob& job);
 
     /**
      * Validation logic for compact filters request handling.
@@ -1246,7 +1339,7 @@ bool PeerManagerImpl::BlockRequested(NodeId nodeid, const CBlockIndex& block, st
     RemoveBlockRequest(hash, nodeid);
 
     std::list<QueuedBlock>::iterator it = state->vBlocksInFlight.insert(state->vBlocksInFlight.end(),
-            {&block, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&m_mempool) : nullptr)});
+            {&block, std::unique_ptr<PartiallyDownloadedBlock>(pit ? new PartiallyDownloadedBlock(&m_mempool, &m_chainman.GetBlockCheckQueue()) : nullptr)});
     if (state->vBlocksInFlight.size() == 1) {
         // We're starting a block download (batch) from this peer.
         state->m_downloading_since = GetTime<std::chrono::microseconds>();
@@ -1604,6 +1697,11 @@ void PeerManagerImpl::ReattemptInitialBroadcast(CScheduler& scheduler)
 void PeerManagerImpl::FinalizeNode(const CNode& node)
 {
     NodeId nodeid = node.GetId();
+    if (PeerRef peer{GetPeerRef(nodeid)}) {
+        // The node must outlive a block request that is still being served.
+        WAIT_LOCK(m_getdata_jobs_mutex, lock);
+        m_getdata_jobs_cv.wait(lock, [&] { return !peer->m_getdata_in_flight; });
+    }
     int misbehavior{0};
     {
     LOCK(cs_main);
@@ -1944,6 +2042,23 @@ PeerManagerImpl::PeerManagerImpl(CConnman& connman, AddrMan& addrman,
     if (opts.reconcile_txs) {
         m_txreconciliation = std::make_unique<TxReconciliationTracker>(TXRECONCILIATION_VERSION);
     }
+
+    for (int n{0}; n < opts.getdata_threads; ++n) {
+        m_getdata_threads.emplace_back(&util::TraceThread, strprintf("getdata.%i", n), [this] { ThreadGetData(); });
+    }
+
+    if (opts.block_hash_threads > 0) {
+        m_block_hash_queue = std::make_unique<CCheckQueue<BlockHashJob>>(/*batch_size=*/1, opts.block_hash_threads, "blockhash");
+    }
+}
+
+PeerManagerImpl::~PeerManagerImpl()
+{
+    WITH_LOCK(m_getdata_jobs_mutex, m_getdata_stop = true);
+    m_getdata_jobs_cv.notify_all();
+    for (std::thread& thread : m_getdata_threads) {
+        thread.join();
+    }
 }
 
 void PeerManagerImpl::StartScheduledTasks(CScheduler& scheduler)
@@ -2041,8 +2156,13 @@ void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::sha
     if (!DeploymentActiveAt(*pindex, m_chainman, Consensus::DEPLOYMENT_SEGWIT)) return;
 
     uint256 hashBlock(pblock->GetHash());
+    // Serialized only if a peer needs it, then shared by all peers it is sent to.
     const std::shared_future<CSerializedNetMsg> lazy_ser{
-        std::async(std::launch::deferred, [&] { return NetMsg::Make(NetMsgType::CMPCTBLOCK, *pcmpctblock); })};
+        std::async(std::launch::deferred, [pcmpctblock] {
+            CSerializedNetMsg msg{NetMsg::Make(NetMsgType::CMPCTBLOCK, *pcmpctblock)};
+            msg.SharePayload();
+            return msg;
+        })};
 
     {
         auto most_recent_block_txs = std::make_unique<std::map<uint256, CTransactionRef>>();
@@ -2055,6 +2175,8 @@ void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::sha
         m_most_recent_block_hash = hashBlock;
         m_most_recent_block = pblock;
         m_most_recent_compact_block = pcmpctblock;
+        m_most_recent_compact_block_msg = lazy_ser;
+        m_most_recent_block_msg.reset();
         m_most_recent_block_txs = std::move(most_recent_block_txs);
     }
 
@@ -2268,10 +2390,12 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
 {
     std::shared_ptr<const CBlock> a_recent_block;
     std::shared_ptr<const CBlockHeaderAndShortTxIDs> a_recent_compact_block;
+    std::shared_future<CSerializedNetMsg> a_recent_compact_block_msg;
     {
         LOCK(m_most_recent_block_mutex);
         a_recent_block = m_most_recent_block;
         a_recent_compact_block = m_most_recent_compact_block;
+        a_recent_compact_block_msg = m_most_recent_compact_block_msg;
     }
 
     bool need_activate_chain = false;
@@ -2329,17 +2453,38 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
     if (!(pindex->nStatus & BLOCK_HAVE_DATA)) {
         return;
     }
+    const bool have_recent_block{a_recent_block && a_recent_block->GetHash() == pindex->GetBlockHash()};
+    if (!m_getdata_threads.empty() && !have_recent_block && (inv.IsMsgWitnessBlk() || inv.IsMsgBlk())) {
+        // Plain blocks from disk are read and sent by a getdata thread, so
+        // that a peer downloading old blocks doesn't hold up everyone else.
+        GetDataJob job{.node = &pfrom, .peer = GetPeerRef(pfrom.GetId()), .inv = inv, .pos = pindex->GetBlockPos()};
+        {
+            LOCK(peer.m_block_inv_mutex);
+            if (inv.hash == peer.m_continuation_block) {
+                job.continuation_tip = m_chainman.ActiveChain().Tip()->GetBlockHash();
+                peer.m_continuation_block.SetNull();
+            }
+        }
+        peer.m_getdata_in_flight = true;
+        WITH_LOCK(m_getdata_jobs_mutex, m_getdata_jobs.push_back(std::move(job)));
+        m_getdata_jobs_cv.notify_all();
+        return;
+    }
     std::shared_ptr<const CBlock> pblock;
-    if (a_recent_block && a_recent_block->GetHash() == pindex->GetBlockHash()) {
+    if (have_recent_block) {
         pblock = a_recent_block;
     } else if (inv.IsMsgWitnessBlk()) {
         // Fast-path: in this case it is possible to serve the block directly from disk,
         // as the network format matches the format on disk
-        std::vector<uint8_t> block_data;
-        if (!m_chainman.m_blockman.ReadRawBlockFromDisk(block_data, pindex->GetBlockPos())) {
-            assert(!"cannot load block from disk");
+        if (const auto mapped_block{m_chainman.m_blockman.MapRawBlock(pindex->GetBlockPos())}) {
+            MakeAndPushMessage(pfrom, NetMsgType::BLOCK, mapped_block->data);
+        } else {
+            std::vector<uint8_t> block_data;
+            if (!m_chainman.m_blockman.ReadRawBlockFromDisk(block_data, pindex->GetBlockPos())) {
+                assert(!"cannot load block from disk");
+            }
+            MakeAndPushMessage(pfrom, NetMsgType::BLOCK, Span{block_data});
         }
-        MakeAndPushMessage(pfrom, NetMsgType::BLOCK, Span{block_data});
         // Don't set pblock as we've sent the block
     } else {
         // Send block from disk
@@ -2353,7 +2498,11 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
         if (inv.IsMsgBlk()) {
             MakeAndPushMessage(pfrom, NetMsgType::BLOCK, TX_NO_WITNESS(*pblock));
         } else if (inv.IsMsgWitnessBlk()) {
-            MakeAndPushMessage(pfrom, NetMsgType::BLOCK, TX_WITH_WITNESS(*pblock));
+            if (auto msg{MostRecentBlockMsg(pblock)}) {
+                PushMessage(pfrom, std::move(*msg));
+            } else {
+                MakeAndPushMessage(pfrom, NetMsgType::BLOCK, TX_WITH_WITNESS(*pblock));
+            }
         } else if (inv.IsMsgFilteredBlk()) {
             bool sendMerkleBlock = false;
             CMerkleBlock merkleBlock;
@@ -2385,7 +2534,11 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
             // instead we respond with the full, non-compact block.
             if (CanDirectFetch() && pindex->nHeight >= m_chainman.ActiveChain().Height() - MAX_CMPCTBLOCK_DEPTH) {
                 if (a_recent_compact_block && a_recent_compact_block->header.GetHash() == pindex->GetBlockHash()) {
-                    MakeAndPushMessage(pfrom, NetMsgType::CMPCTBLOCK, *a_recent_compact_block);
+                    if (a_recent_compact_block_msg.valid()) {
+                        PushMessage(pfrom, a_recent_compact_block_msg.get().Copy());
+                    } else {
+                        MakeAndPushMessage(pfrom, NetMsgType::CMPCTBLOCK, *a_recent_compact_block);
+                    }
                 } else {
                     CBlockHeaderAndShortTxIDs cmpctblock{*pblock};
                     MakeAndPushMessage(pfrom, NetMsgType::CMPCTBLOCK, cmpctblock);
@@ -2411,6 +2564,79 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
     }
 }
 
+void PeerManagerImpl::ThreadGetData()
+{
+    while (true) {
+        GetDataJob job;
+        {
+            WAIT_LOCK(m_getdata_jobs_mutex, lock);
+            m_getdata_jobs_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_getdata_jobs_mutex) { return m_getdata_stop || !m_getdata_jobs.empty(); });
+            if (m_getdata_stop) return;
+            job = std::move(m_getdata_jobs.front());
+            m_getdata_jobs.pop_front();
+        }
+
+        ServeBlockFromDisk(job);
+
+        WITH_LOCK(m_getdata_jobs_mutex, job.peer->m_getdata_in_flight = false);
+        m_getdata_jobs_cv.notify_all();
+        // Let the message handler continue with this peer.
+        m_connman.WakeMessageHandler();
+    }
+}
+
+void PeerManagerImpl::ServeBlockFromDisk(const GetDataJob& job)
+{
+    CNode& pfrom{*job.node};
+    bool read_ok;
+    if (job.inv.IsMsgWitnessBlk()) {
+        // The network format matches the format on disk
+        if (const auto mapped_block{m_chainman.m_blockman.MapRawBlock(job.pos)}) {
+            MakeAndPushMessage(pfrom, NetMsgType::BLOCK, mapped_block->data);
+            read_ok = true;
+        } else {
+            std::vector<uint8_t> block_data;
+            read_ok = m_chainman.m_blockman.ReadRawBlockFromDisk(block_data, job.pos);
+            if (read_ok) MakeAndPushMessage(pfrom, NetMsgType::BLOCK, Span{block_data});
+        }
+    } else {
+        CBlock block;
+        read_ok = m_chainman.m_blockman.ReadBlockFromDisk(block, job.pos) && block.GetHash() == job.inv.hash;
+        if (read_ok) MakeAndPushMessage(pfrom, NetMsgType::BLOCK, TX_NO_WITNESS(block));
+    }
+    if (!read_ok) {
+        // cs_main is not held anymore, so the block may have been pruned in the meantime.
+        LogPrint(BCLog::NET, "Cannot load block %s from disk, disconnect peer=%d\n", job.inv.hash.ToString(), pfrom.GetId());
+        pfrom.fDisconnect = true;
+        return;
+    }
+    if (job.continuation_tip) {
+        MakeAndPushMessage(pfrom, NetMsgType::INV, std::vector<CInv>{{MSG_BLOCK, *job.continuation_tip}});
+    }
+}
+
+std::optional<CSerializedNetMsg> PeerManagerImpl::MostRecentBlockMsg(const std::shared_ptr<const CBlock>& block)
+{
+    if (!block) return std::nullopt;
+    {
+        LOCK(m_most_recent_block_mutex);
+        if (block != m_most_recent_block) return std::nullopt;
+        if (m_most_recent_block_msg) return m_most_recent_block_msg->Copy();
+    }
+
+    // Serialize without holding the lock, so that other peers are not held up.
+    CSerializedNetMsg msg{NetMsg::Make(NetMsgType::BLOCK, TX_WITH_WITNESS(*block))};
+    msg.SharePayload();
+
+    LOCK(m_most_recent_block_mutex);
+    // Publish the message, unless another request did so meanwhile or a new block
+    // replaced this one.
+    if (block == m_most_recent_block && !m_most_recent_block_msg) {
+        m_most_recent_block_msg = msg.Copy();
+    }
+    return msg;
+}
+
 CTransactionRef PeerManagerImpl::FindTxForGetData(const Peer::TxRelay& tx_relay, const GenTxid& gtxid)
 {
     // If a tx was in the mempool prior to the last INV for this peer, permit the request.
@@ -2435,6 +2661,9 @@ void PeerManagerImpl::ProcessGetData(CNode& pfrom, Peer& peer, const std::atomic
 {
     AssertLockNotHeld(cs_main);
 
+    // Wait for the block being served to be sent first.
+    if (peer.m_getdata_in_flight) return;
+
     auto tx_relay = peer.GetTxRelay();
 
     std::deque<CInv>::iterator it = peer.m_getdata_requests.begin();
@@ -4517,7 +4746,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 std::list<QueuedBlock>::iterator* queuedBlockIt = nullptr;
                 if (!BlockRequested(pfrom.GetId(), *pindex, &queuedBlockIt)) {
                     if (!(*queuedBlockIt)->partialBlock)
-                        (*queuedBlockIt)->partialBlock.reset(new PartiallyDownloadedBlock(&m_mempool));
+                        (*queuedBlockIt)->partialBlock.reset(new PartiallyDownloadedBlock(&m_mempool, &m_chainman.GetBlockCheckQueue()));
                     else {
                         // The block was already in flight using compact blocks from the same peer
                         LogPrint(BCLog::NET, "Peer sent us compact block we were already syncing!\n");
@@ -4576,7 +4805,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 // download from.
                 // Optimistically try to reconstruct anyway since we might be
                 // able to without any round trips.
-                PartiallyDownloadedBlock tempBlock(&m_mempool);
+                PartiallyDownloadedBlock tempBlock(&m_mempool, &m_chainman.GetBlockCheckQueue());
                 ReadStatus status = tempBlock.InitData(cmpctblock, vExtraTxnForCompact);
                 if (status != READ_STATUS_OK) {
                     // TODO: don't ignore failures
@@ -4715,7 +4944,10 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         }
 
         std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-        vRecv >> TX_WITH_WITNESS(*pblock);
+        ParamsStream s{TX_WITH_WITNESS, vRecv};
+        UnserializeBlock(s, *pblock, [&](unsigned char* out, const unsigned char* const* in, const size_t* lengths, size_t count) {
+            HashBatchParallel(out, in, lengths, count, m_block_hash_queue.get(), m_opts.block_hash_threads);
+        });
 
         LogPrint(BCLog::NET, "received block %s peer=%d\n", pblock->GetHash().ToString(), pfrom.GetId());
 
@@ -5050,6 +5282,9 @@ bool PeerManagerImpl::ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt
     PeerRef peer = GetPeerRef(pfrom->GetId());
     if (peer == nullptr) return false;
 
+    // Responses keep their order, the getdata thread wakes us up once it is done.
+    if (peer->m_getdata_in_flight) return false;
+
     {
         LOCK(peer->m_getdata_requests_mutex);
         if (!peer->m_getdata_requests.empty()) {
@@ -5692,15 +5927,15 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                     LogPrint(BCLog::NET, "%s sending header-and-ids %s to peer=%d\n", __func__,
                             vHeaders.front().GetHash().ToString(), pto->GetId());
 
-                    std::optional<CSerializedNetMsg> cached_cmpctblock_msg;
+                    std::shared_future<CSerializedNetMsg> cached_cmpctblock_msg;
                     {
                         LOCK(m_most_recent_block_mutex);
                         if (m_most_recent_block_hash == pBestIndex->GetBlockHash()) {
-                            cached_cmpctblock_msg = NetMsg::Make(NetMsgType::CMPCTBLOCK, *m_most_recent_compact_block);
+                            cached_cmpctblock_msg = m_most_recent_compact_block_msg;
                         }
                     }
-                    if (cached_cmpctblock_msg.has_value()) {
-                        PushMessage(*pto, std::move(cached_cmpctblock_msg.value()));
+                    if (cached_cmpctblock_msg.valid()) {
+                        PushMessage(*pto, cached_cmpctblock_msg.get().Copy());
                     } else {
                         CBlock block;
                         const bool ret{m_chainman.m_blockman.ReadBlockFromDisk(block, *pBestIndex)};
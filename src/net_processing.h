@@ -21,6 +21,14 @@ static const uint32_t DEFAULT_MAX_ORPHAN_TRANSACTIONS{100};
 /** Default number of non-mempool transactions to keep around for block reconstruction. Includes
     orphan, replaced, and rejected transactions. */
 static const uint32_t DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN{100};
+/** Default number of threads serving blocks from disk in response to getdata (0 = serve them on the message handler thread) */
+static constexpr int DEFAULT_GETDATA_THREADS{0};
+/** Maximum number of threads serving blocks from disk in response to getdata */
+static constexpr int MAX_GETDATA_THREADS{16};
+/** Default number of extra threads hashing the transactions of blocks received from peers (0 = hash them on the message handler thread) */
+static constexpr int DEFAULT_BLOCK_HASH_THREADS{0};
+/** Maximum number of extra threads hashing the transactions of blocks received from peers */
+static constexpr int MAX_BLOCK_HASH_THREADS{16};
 static const bool DEFAULT_PEERBLOOMFILTERS = false;
 static const bool DEFAULT_PEERBLOCKFILTERS = false;
 /** Threshold for marking a node to be discouraged, e.g. disconnected and added to the discouragement filter. */
@@ -58,6 +66,10 @@ public:
         uint32_t max_extra_txs{DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN};
         //! Whether all P2P messages are captured to disk
         bool capture_messages{false};
+        //! Number of threads reading blocks requested with getdata from disk
+        int getdata_threads{DEFAULT_GETDATA_THREADS};
+        //! Number of extra threads hashing the transactions of received blocks
+        int block_hash_threads{DEFAULT_BLOCK_HASH_THREADS};
         //! Whether or not the internal RNG behaves deterministically (this is
         //! a test-only option).
         bool deterministic_rng{false};
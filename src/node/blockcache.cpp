@@ -0,0 +1,131 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockcache.h>
+
+#include <core_memusage.h>
+#include <memusage.h>
+#include <primitives/block.h>
+
+#include <utility>
+
+namespace node {
+
+BlockCache::BlockCache(size_t max_usage)
+    : m_shard_max_usage{max_usage / NUM_SHARDS} {}
+
+BlockCache::Shard& BlockCache::GetShard(const FlatFilePos& pos)
+{
+    // Mix the bits, so that the consecutive blocks of a file are spread over the shards.
+    return m_shards[(uint64_t{PosHasher{}(pos)} * 0x9E3779B97F4A7C15ULL >> 32) % NUM_SHARDS];
+}
+
+BlockCache::Entry* BlockCache::Lookup(Shard& shard, const FlatFilePos& pos)
+{
+    const auto it{shard.m_entries.find(pos)};
+    if (it == shard.m_entries.end()) return nullptr;
+    shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, it->second.lru_it);
+    return &it->second;
+}
+
+std::shared_ptr<const std::vector<uint8_t>> BlockCache::GetRaw(const FlatFilePos& pos)
+{
+    Shard& shard{GetShard(pos)};
+    std::shared_ptr<const std::vector<uint8_t>> raw;
+    {
+        LOCK(shard.m_mutex);
+        if (const Entry* entry{Lookup(shard, pos)}) raw = entry->raw;
+    }
+    (raw ? m_raw_hits : m_raw_misses).fetch_add(1, std::memory_order_relaxed);
+    return raw;
+}
+
+std::shared_ptr<const CBlock> BlockCache::GetBlock(const FlatFilePos& pos)
+{
+    Shard& shard{GetShard(pos)};
+    std::shared_ptr<const CBlock> block;
+    {
+        LOCK(shard.m_mutex);
+        if (const Entry* entry{Lookup(shard, pos)}) block = entry->block;
+    }
+    (block ? m_block_hits : m_block_misses).fetch_add(1, std::memory_order_relaxed);
+    return block;
+}
+
+void BlockCache::PutRaw(const FlatFilePos& pos, std::shared_ptr<const std::vector<uint8_t>> raw)
+{
+    Put(pos, std::move(raw), nullptr);
+}
+
+void BlockCache::PutBlock(const FlatFilePos& pos, std::shared_ptr<const CBlock> block)
+{
+    Put(pos, nullptr, std::move(block));
+}
+
+void BlockCache::Put(const FlatFilePos& pos, std::shared_ptr<const std::vector<uint8_t>> raw, std::shared_ptr<const CBlock> block)
+{
+    // Walking the transactions is done outside of the lock.
+    const size_t raw_usage{raw ? memusage::DynamicUsage(*raw) : 0};
+    const size_t block_usage{block ? RecursiveDynamicUsage(*block) : 0};
+
+    Shard& shard{GetShard(pos)};
+    LOCK(shard.m_mutex);
+    Entry* entry{Lookup(shard, pos)};
+    if (!entry) {
+        shard.m_lru.push_front(pos);
+        entry = &shard.m_entries.emplace(pos, Entry{.lru_it = shard.m_lru.begin()}).first->second;
+    }
+    if (raw && !entry->raw) {
+        entry->raw = std::move(raw);
+        entry->usage += raw_usage;
+        shard.m_usage += raw_usage;
+    }
+    if (block && !entry->block) {
+        entry->block = std::move(block);
+        entry->usage += block_usage;
+        shard.m_usage += block_usage;
+    }
+
+    // This drops the new entry too if it is larger than the shard's limit.
+    while (shard.m_usage > m_shard_max_usage) {
+        const auto it{shard.m_entries.find(shard.m_lru.back())};
+        shard.m_usage -= it->second.usage;
+        shard.m_entries.erase(it);
+        shard.m_lru.pop_back();
+    }
+}
+
+void BlockCache::EraseFile(int file_num)
+{
+    for (Shard& shard : m_shards) {
+        LOCK(shard.m_mutex);
+        for (auto it{shard.m_entries.begin()}; it != shard.m_entries.end();) {
+            if (it->first.nFile == file_num) {
+                shard.m_usage -= it->second.usage;
+                shard.m_lru.erase(it->second.lru_it);
+                it = shard.m_entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+BlockCache::Stats BlockCache::GetStats() const
+{
+    Stats stats;
+    stats.max_usage = m_shard_max_usage * NUM_SHARDS;
+    for (const Shard& shard : m_shards) {
+        LOCK(shard.m_mutex);
+        stats.usage += shard.m_usage;
+        stats.entries += shard.m_entries.size();
+    }
+    stats.raw_hits = m_raw_hits.load(std::memory_order_relaxed);
+    stats.raw_misses = m_raw_misses.load(std::memory_order_relaxed);
+    stats.block_hits = m_block_hits.load(std::memory_order_relaxed);
+    stats.block_misses = m_block_misses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace node
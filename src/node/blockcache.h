@@ -0,0 +1,107 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_BLOCKCACHE_H
+#define BITCOIN_NODE_BLOCKCACHE_H
+
+#include <flatfile.h>
+#include <sync.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class CBlock;
+
+namespace node {
+
+/**
+ * Size-bounded cache of blocks recently read from disk, keyed by their
+ * position in the block files. It is shared by everything that reads blocks
+ * through the BlockManager (P2P, REST, RPC), so that serving the same recent
+ * blocks over and over does not hit the disk.
+ *
+ * An entry holds the serialized block, the deserialized block or both,
+ * depending on how the block was read. The cache is split into shards, each
+ * with its own lock, least recently used list and share of the memory limit,
+ * so that concurrent readers rarely contend.
+ */
+class BlockCache
+{
+public:
+    struct Stats {
+        size_t usage{0};
+        size_t max_usage{0};
+        size_t entries{0};
+        uint64_t raw_hits{0};
+        uint64_t raw_misses{0};
+        uint64_t block_hits{0};
+        uint64_t block_misses{0};
+    };
+
+    static constexpr size_t NUM_SHARDS{8};
+
+    explicit BlockCache(size_t max_usage);
+
+    BlockCache(const BlockCache&) = delete;
+    BlockCache& operator=(const BlockCache&) = delete;
+
+    //! Return the serialized block at pos, or nullptr if it is not cached.
+    std::shared_ptr<const std::vector<uint8_t>> GetRaw(const FlatFilePos& pos);
+    //! Return the deserialized block at pos, or nullptr if it is not cached.
+    std::shared_ptr<const CBlock> GetBlock(const FlatFilePos& pos);
+
+    //! Add the serialized block at pos, evicting the least recently used entries if needed.
+    void PutRaw(const FlatFilePos& pos, std::shared_ptr<const std::vector<uint8_t>> raw);
+    //! Add the deserialized block at pos, evicting the least recently used entries if needed.
+    void PutBlock(const FlatFilePos& pos, std::shared_ptr<const CBlock> block);
+
+    //! Drop all blocks of a block file, e.g. when it is pruned.
+    void EraseFile(int file_num);
+
+    Stats GetStats() const;
+
+private:
+    struct PosHasher {
+        size_t operator()(const FlatFilePos& pos) const { return std::hash<uint64_t>{}(uint64_t(uint32_t(pos.nFile)) << 32 | pos.nPos); }
+    };
+
+    struct Entry {
+        std::shared_ptr<const std::vector<uint8_t>> raw;
+        std::shared_ptr<const CBlock> block;
+        size_t usage{0};
+        std::list<FlatFilePos>::iterator lru_it;
+    };
+
+    struct Shard {
+        mutable Mutex m_mutex;
+        //! Most recently used first
+        std::list<FlatFilePos> m_lru GUARDED_BY(m_mutex);
+        std::unordered_map<FlatFilePos, Entry, PosHasher> m_entries GUARDED_BY(m_mutex);
+        size_t m_usage GUARDED_BY(m_mutex){0};
+    };
+
+    const size_t m_shard_max_usage;
+    std::array<Shard, NUM_SHARDS> m_shards;
+
+    std::atomic<uint64_t> m_raw_hits{0};
+    std::atomic<uint64_t> m_raw_misses{0};
+    std::atomic<uint64_t> m_block_hits{0};
+    std::atomic<uint64_t> m_block_misses{0};
+
+    Shard& GetShard(const FlatFilePos& pos);
+    //! Find the entry at pos, and mark it as most recently used.
+    Entry* Lookup(Shard& shard, const FlatFilePos& pos) EXCLUSIVE_LOCKS_REQUIRED(shard.m_mutex);
+    //! Add the given data to the entry at pos, then shrink the shard back below its limit.
+    void Put(const FlatFilePos& pos, std::shared_ptr<const std::vector<uint8_t>> raw, std::shared_ptr<const CBlock> block);
+};
+
+} // namespace node
+
+#endif // BITCOIN_NODE_BLOCKCACHE_H
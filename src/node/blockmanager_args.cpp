@@ -11,7 +11,9 @@
 #include <util/translation.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 
 namespace node {
 util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Options& opts)
@@ -32,6 +34,10 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Op
     opts.prune_target = nPruneTarget;
 
     if (auto value{args.GetBoolArg("-fastprune")}) opts.fast_prune = *value;
+    if (auto value{args.GetBoolArg("-blocksmmap")}) opts.use_mmap = *value;
+    if (auto value{args.GetIntArg("-blockcachesize")}) {
+        opts.block_cache_bytes = size_t(std::clamp<int64_t>(*value, 0, std::numeric_limits<size_t>::max() >> 20)) << 20;
+    }
 
     return {};
 }
@@ -8,6 +8,7 @@
 #include <chain.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
+#include <crypto/common.h>
 #include <dbwrapper.h>
 #include <flatfile.h>
 #include <hash.h>
@@ -36,9 +37,17 @@
 #include <util/translation.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <map>
 #include <unordered_map>
 
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace kernel {
 static constexpr uint8_t DB_BLOCK_FILES{'f'};
 static constexpr uint8_t DB_BLOCK_INDEX{'b'};
@@ -150,6 +159,47 @@ bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, s
 namespace node {
 std::atomic_bool fReindex(false);
 
+/** A block file mapped read-only into memory. */
+class MappedBlockFile
+{
+    void* const m_addr;
+    const size_t m_size;
+
+public:
+    MappedBlockFile(void* addr, size_t size) : m_addr{addr}, m_size{size} {}
+    ~MappedBlockFile()
+    {
+#ifndef WIN32
+        munmap(m_addr, m_size);
+#endif
+    }
+
+    MappedBlockFile(const MappedBlockFile&) = delete;
+    MappedBlockFile& operator=(const MappedBlockFile&) = delete;
+
+    Span<const uint8_t> Data() const { return {static_cast<const uint8_t*>(m_addr), m_size}; }
+
+    //! Map the whole file, or return nullptr if that is not possible.
+    static std::shared_ptr<const MappedBlockFile> Map(const fs::path& path)
+    {
+#ifdef WIN32
+        return nullptr;
+#else
+        const int fd{open(fs::PathToString(path).c_str(), O_RDONLY | O_CLOEXEC)};
+        if (fd == -1) return nullptr;
+        struct stat st;
+        void* addr{MAP_FAILED};
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        // The mapping stays valid after closing the file.
+        close(fd);
+        if (addr == MAP_FAILED) return nullptr;
+        return std::make_shared<const MappedBlockFile>(addr, static_cast<size_t>(st.st_size));
+#endif
+    }
+};
+
 bool CBlockIndexWorkComparator::operator()(const CBlockIndex* pa, const CBlockIndex* pb) const
 {
     // First sort by most total work, ...
@@ -804,6 +854,9 @@ void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
 {
     std::error_code ec;
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
+        // Readers still using the mapping keep it alive until they are done.
+        WITH_LOCK(m_mapped_files_mutex, m_mapped_files.erase(*it));
+        if (m_block_cache) m_block_cache->EraseFile(*it);
         FlatFilePos pos(*it, 0);
         const bool removed_blockfile{fs::remove(BlockFileSeq().FileName(pos), ec)};
         const bool removed_undofile{fs::remove(UndoFileSeq().FileName(pos), ec)};
@@ -1024,21 +1077,89 @@ bool BlockManager::WriteUndoDataForBlock(const CBlockUndo& blockundo, BlockValid
     return true;
 }
 
+std::shared_ptr<const MappedBlockFile> BlockManager::MapBlockFile(int file_num) const
+{
+    {
+        LOCK(cs_LastBlockFile);
+        for (const auto& cursor : m_blockfile_cursors) {
+            if (cursor && cursor->file_num == file_num) return nullptr;
+        }
+    }
+
+    LOCK(m_mapped_files_mutex);
+    ++m_mapped_files_uses;
+    if (auto it{m_mapped_files.find(file_num)}; it != m_mapped_files.end()) {
+        it->second.second = m_mapped_files_uses;
+        return it->second.first;
+    }
+    auto file{MappedBlockFile::Map(BlockFileSeq().FileName(FlatFilePos{file_num, 0}))};
+    if (!file) {
+        LogPrint(BCLog::BLOCKSTORAGE, "Failed to map block file %05u, reading it instead\n", file_num);
+        return nullptr;
+    }
+    if (m_mapped_files.size() >= MAX_MAPPED_BLOCK_FILES) {
+        // Unmap the least recently used file
+        m_mapped_files.erase(std::min_element(m_mapped_files.begin(), m_mapped_files.end(),
+                                              [](const auto& a, const auto& b) { return a.second.second < b.second.second; }));
+    }
+    m_mapped_files.emplace(file_num, std::make_pair(file, m_mapped_files_uses));
+    return file;
+}
+
+std::optional<MappedBlock> BlockManager::MapRawBlock(const FlatFilePos& pos) const
+{
+    if (!m_opts.use_mmap || pos.IsNull() || pos.nPos < BLOCK_SERIALIZATION_HEADER_SIZE) return std::nullopt;
+    auto file{MapBlockFile(pos.nFile)};
+    if (!file) return std::nullopt;
+
+    // Leave reporting any errors in the meta header to ReadRawBlockFromDisk.
+    const Span<const uint8_t> data{file->Data()};
+    if (pos.nPos > data.size()) return std::nullopt;
+    const auto header{data.subspan(pos.nPos - BLOCK_SERIALIZATION_HEADER_SIZE, BLOCK_SERIALIZATION_HEADER_SIZE)};
+    const MessageStartChars& message_start{GetParams().MessageStart()};
+    if (!std::equal(message_start.begin(), message_start.end(), header.begin())) return std::nullopt;
+    const uint32_t blk_size{ReadLE32(header.data() + message_start.size())};
+    if (blk_size > MAX_SIZE || blk_size > data.size() - pos.nPos) return std::nullopt;
+
+    return MappedBlock{std::move(file), data.subspan(pos.nPos, blk_size)};
+}
+
+std::optional<BlockCache::Stats> BlockManager::GetBlockCacheStats() const
+{
+    if (!m_block_cache) return std::nullopt;
+    return m_block_cache->GetStats();
+}
+
 bool BlockManager::ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos) const
 {
     block.SetNull();
 
-    // Open history file to read
-    AutoFile filein{OpenBlockFile(pos, true)};
-    if (filein.IsNull()) {
-        return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
+    if (m_block_cache) {
+        if (const auto cached_block{m_block_cache->GetBlock(pos)}) {
+            block = *cached_block;
+            return true;
+        }
     }
 
-    // Read block
-    try {
-        filein >> TX_WITH_WITNESS(block);
-    } catch (const std::exception& e) {
-        return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+    if (const auto mapped{MapRawBlock(pos)}) {
+        try {
+            SpanReader{mapped->data} >> TX_WITH_WITNESS(block);
+        } catch (const std::exception& e) {
+            return error("%s: Deserialize error - %s at %s", __func__, e.what(), pos.ToString());
+        }
+    } else {
+        // Open history file to read
+        AutoFile filein{OpenBlockFile(pos, true)};
+        if (filein.IsNull()) {
+            return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
+        }
+
+        // Read block
+        try {
+            filein >> TX_WITH_WITNESS(block);
+        } catch (const std::exception& e) {
+            return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+        }
     }
 
     // Check the header
@@ -1051,6 +1172,7 @@ bool BlockManager::ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos) cons
         return error("ReadBlockFromDisk: Errors in block solution at %s", pos.ToString());
     }
 
+    if (m_block_cache) m_block_cache->PutBlock(pos, std::make_shared<const CBlock>(block));
     return true;
 }
 
@@ -1070,6 +1192,19 @@ bool BlockManager::ReadBlockFromDisk(CBlock& block, const CBlockIndex& index) co
 
 bool BlockManager::ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos) const
 {
+    if (m_block_cache) {
+        if (const auto cached_block{m_block_cache->GetRaw(pos)}) {
+            block = *cached_block;
+            return true;
+        }
+    }
+
+    // Mapped blocks are already in memory, so they are not cached again.
+    if (const auto mapped{MapRawBlock(pos)}) {
+        block.assign(mapped->data.begin(), mapped->data.end());
+        return true;
+    }
+
     FlatFilePos hpos = pos;
     hpos.nPos -= 8; // Seek back 8 bytes for meta header
     AutoFile filein{OpenBlockFile(hpos, true)};
@@ -1100,6 +1235,7 @@ bool BlockManager::ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatF
         return error("%s: Read from block file failed: %s for %s", __func__, e.what(), pos.ToString());
     }
 
+    if (m_block_cache) m_block_cache->PutRaw(pos, std::make_shared<const std::vector<uint8_t>>(block));
     return true;
 }
 
@@ -13,7 +13,9 @@
 #include <kernel/chainparams.h>
 #include <kernel/cs_main.h>
 #include <kernel/messagestartchars.h>
+#include <node/blockcache.h>
 #include <primitives/block.h>
+#include <span.h>
 #include <streams.h>
 #include <sync.h>
 #include <uint256.h>
@@ -44,6 +46,9 @@ struct Params;
 namespace util {
 class SignalInterrupt;
 } // namespace util
+namespace node {
+class MappedBlockFile;
+} // namespace node
 
 namespace kernel {
 /** Access to the block database (blocks/index/) */
@@ -76,6 +81,9 @@ static const unsigned int MAX_BLOCKFILE_SIZE = 0x8000000; // 128 MiB
 /** Size of header written by WriteBlockToDisk before a serialized CBlock */
 static constexpr size_t BLOCK_SERIALIZATION_HEADER_SIZE = std::tuple_size_v<MessageStartChars> + sizeof(unsigned int);
 
+/** The maximum number of block files kept memory-mapped with -blocksmmap */
+static constexpr size_t MAX_MAPPED_BLOCK_FILES{64};
+
 extern std::atomic_bool fReindex;
 
 // Because validation code takes pointers to the map's CBlockIndex objects, if
@@ -125,6 +133,11 @@ struct BlockfileCursor {
 
 std::ostream& operator<<(std::ostream& os, const BlockfileCursor& cursor);
 
+/** A serialized block in a memory-mapped block file. The file stays mapped for as long as this is kept around. */
+struct MappedBlock {
+    std::shared_ptr<const MappedBlockFile> file;
+    Span<const uint8_t> data;
+};
 
 /**
  * Maintains a tree of blocks (stored in `m_block_index`) which is consulted
@@ -196,7 +209,8 @@ private:
         const Chainstate& chain,
         ChainstateManager& chainman);
 
-    RecursiveMutex cs_LastBlockFile;
+    //! Mutable, so that readers can check which files are still being written to.
+    mutable RecursiveMutex cs_LastBlockFile;
     std::vector<CBlockFileInfo> m_blockfile_info;
 
     //! Since assumedvalid chainstates may be syncing a range of the chain that is very
@@ -248,12 +262,25 @@ private:
 
     const kernel::BlockManagerOpts m_opts;
 
+    mutable Mutex m_mapped_files_mutex;
+    //! Memory-mapped block files by file number, with the use count they were last used at, if Options::use_mmap is set.
+    mutable std::map<int, std::pair<std::shared_ptr<const MappedBlockFile>, uint64_t>> m_mapped_files GUARDED_BY(m_mapped_files_mutex);
+    mutable uint64_t m_mapped_files_uses GUARDED_BY(m_mapped_files_mutex){0};
+
+    /** Map a block file into memory, or return a mapping of it that is still around.
+     *  Only files that are no longer written to are mapped. Returns nullptr if the file can't be mapped. */
+    std::shared_ptr<const MappedBlockFile> MapBlockFile(int file_num) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
+
+    //! Recently read blocks, if Options::block_cache_bytes is set.
+    const std::unique_ptr<BlockCache> m_block_cache;
+
 public:
     using Options = kernel::BlockManagerOpts;
 
     explicit BlockManager(const util::SignalInterrupt& interrupt, Options opts)
         : m_prune_mode{opts.prune_target > 0},
           m_opts{std::move(opts)},
+          m_block_cache{m_opts.block_cache_bytes > 0 ? std::make_unique<BlockCache>(m_opts.block_cache_bytes) : nullptr},
           m_interrupt{interrupt} {};
 
     const util::SignalInterrupt& m_interrupt;
@@ -358,12 +385,23 @@ public:
     /**
      *  Actually unlink the specified files
      */
-    void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const;
+    void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
 
     /** Functions for disk access for blocks */
-    bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos) const;
-    bool ReadBlockFromDisk(CBlock& block, const CBlockIndex& index) const;
-    bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos) const;
+    bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
+    bool ReadBlockFromDisk(CBlock& block, const CBlockIndex& index) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
+    bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
+
+    /**
+     * Return the serialized block at pos from a memory-mapped block file,
+     * without copying it. Returns std::nullopt if -blocksmmap is not set, the
+     * block file is still being written to, or the block can't be found in
+     * the mapping, in which case ReadRawBlockFromDisk should be used instead.
+     */
+    std::optional<MappedBlock> MapRawBlock(const FlatFilePos& pos) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
+
+    /** Statistics of the cache of recently read blocks, or std::nullopt if it is disabled. */
+    std::optional<BlockCache::Stats> GetBlockCacheStats() const;
 
     bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex& index) const;
 
@@ -53,6 +53,13 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, ChainstateManage
     opts.worker_threads_num = std::clamp(script_threads - 1, 0, MAX_SCRIPTCHECK_THREADS);
     LogPrintf("Script verification uses %d additional threads\n", opts.worker_threads_num);
 
+    opts.prefetch_threads_num = std::clamp<int>(args.GetIntArg("-prefetchthreads", DEFAULT_PREFETCH_THREADS), 0, MAX_PREFETCH_THREADS);
+    if (opts.prefetch_threads_num > 0) {
+        LogPrintf("Block input prefetching uses %d threads\n", opts.prefetch_threads_num);
+    }
+
+    opts.block_read_ahead = std::clamp<int>(args.GetIntArg("-blockreadahead", DEFAULT_BLOCK_READ_AHEAD), 0, MAX_BLOCK_READ_AHEAD);
+
     return {};
 }
 } // namespace node
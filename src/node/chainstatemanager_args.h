@@ -14,6 +14,14 @@ class ArgsManager;
 static constexpr int MAX_SCRIPTCHECK_THREADS{15};
 /** -par default (number of script-checking threads, 0 = auto) */
 static constexpr int DEFAULT_SCRIPTCHECK_THREADS{0};
+/** Maximum number of threads prefetching block inputs */
+static constexpr int MAX_PREFETCH_THREADS{64};
+/** -prefetchthreads default (number of threads prefetching block inputs, 0 = disabled) */
+static constexpr int DEFAULT_PREFETCH_THREADS{0};
+/** Maximum number of blocks read ahead of connecting them */
+static constexpr int MAX_BLOCK_READ_AHEAD{16};
+/** -blockreadahead default (number of blocks read ahead of connecting them, 0 = disabled) */
+static constexpr int DEFAULT_BLOCK_READ_AHEAD{0};
 
 namespace node {
 [[nodiscard]] util::Result<void> ApplyArgsManOptions(const ArgsManager& args, ChainstateManager::Options& opts);
@@ -33,6 +33,7 @@ class WalletLoader;
 } // namespace interfaces
 
 namespace node {
+class BlockTemplateCache;
 class KernelNotifications;
 
 //! NodeContext struct containing references to chain state and connection
@@ -71,6 +72,8 @@ struct NodeContext {
     std::unique_ptr<CScheduler> scheduler;
     std::function<void()> rpc_interruption_point = [] {};
     std::unique_ptr<KernelNotifications> notifications;
+    //! Block template kept up to date for getblocktemplate, created on first use.
+    std::unique_ptr<BlockTemplateCache> block_template_cache;
     std::atomic<int> exit_status{EXIT_SUCCESS};
 
     //! Declare default constructor and destructor that are not inline, so code
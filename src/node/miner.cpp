@@ -101,6 +101,20 @@ void BlockAssembler::resetBlock()
     // These counters do not include coinbase tx
     nBlockTx = 0;
     nFees = 0;
+
+    m_min_package_feerate.reset();
+}
+
+static CTransactionRef CreateCoinbaseTx(const CScript& script_pub_key, int height, CAmount value)
+{
+    CMutableTransaction coinbaseTx;
+    coinbaseTx.vin.resize(1);
+    coinbaseTx.vin[0].prevout.SetNull();
+    coinbaseTx.vout.resize(1);
+    coinbaseTx.vout[0].scriptPubKey = script_pub_key;
+    coinbaseTx.vout[0].nValue = value;
+    coinbaseTx.vin[0].scriptSig = CScript() << height << OP_0;
+    return MakeTransactionRef(std::move(coinbaseTx));
 }
 
 std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& scriptPubKeyIn)
@@ -149,14 +163,7 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     m_last_block_weight = nBlockWeight;
 
     // Create coinbase transaction.
-    CMutableTransaction coinbaseTx;
-    coinbaseTx.vin.resize(1);
-    coinbaseTx.vin[0].prevout.SetNull();
-    coinbaseTx.vout.resize(1);
-    coinbaseTx.vout[0].scriptPubKey = scriptPubKeyIn;
-    coinbaseTx.vout[0].nValue = nFees + GetBlockSubsidy(nHeight, chainparams.GetConsensus());
-    coinbaseTx.vin[0].scriptSig = CScript() << nHeight << OP_0;
-    pblock->vtx[0] = MakeTransactionRef(std::move(coinbaseTx));
+    pblock->vtx[0] = CreateCoinbaseTx(scriptPubKeyIn, nHeight, nFees + GetBlockSubsidy(nHeight, chainparams.GetConsensus()));
     pblocktemplate->vchCoinbaseCommitment = m_chainstate.m_chainman.GenerateCoinbaseCommitment(*pblock, pindexPrev);
     pblocktemplate->vTxFees[0] = -nFees;
 
@@ -423,9 +430,146 @@ void BlockAssembler::addPackageTxs(const CTxMemPool& mempool, int& nPackagesSele
         }
 
         ++nPackagesSelected;
+        const CFeeRate package_feerate{packageFees, static_cast<uint32_t>(packageSize)};
+        if (!m_min_package_feerate || package_feerate < *m_min_package_feerate) {
+            m_min_package_feerate = package_feerate;
+        }
 
         // Update transactions that depend on each of these
         nDescendantsUpdated += UpdatePackagesForAdded(mempool, ancestors, mapModifiedTx);
     }
 }
+
+BlockTemplateCache::BlockTemplateCache(ChainstateManager& chainman, const CTxMemPool& mempool)
+    : BlockTemplateCache(chainman, mempool, ConfiguredOptions()) {}
+
+BlockTemplateCache::BlockTemplateCache(ChainstateManager& chainman, const CTxMemPool& mempool, const BlockAssembler::Options& options)
+    : m_chainman{chainman},
+      m_mempool{mempool},
+      m_options{ClampOptions(options)}
+{
+}
+
+std::shared_ptr<CBlockTemplate> BlockTemplateCache::Get(const CScript& script_pub_key)
+{
+    AssertLockHeld(::cs_main);
+    LOCK(m_mutex);
+    Chainstate& chainstate{m_chainman.ActiveChainstate()};
+    if (!m_template || m_tip != chainstate.m_chain.Tip()) {
+        Assemble(chainstate, script_pub_key);
+        return m_template;
+    }
+
+    const size_t num_txs{m_template->block.vtx.size()};
+    if (!m_stale) {
+        LOCK(m_mempool.cs);
+        for (const CTransactionRef& tx : m_added) {
+            if (!Append(*tx)) {
+                m_stale = true;
+                break;
+            }
+        }
+    }
+    m_added.clear();
+
+    if (m_stale && NodeClock::now() - m_assembled_time >= ASSEMBLE_INTERVAL) {
+        Assemble(chainstate, script_pub_key);
+    } else if (m_template->block.vtx.size() != num_txs || script_pub_key != m_script_pub_key) {
+        UpdateCoinbase(script_pub_key);
+    }
+    return m_template;
+}
+
+void BlockTemplateCache::Reset()
+{
+    LOCK(m_mutex);
+    m_stale = true;
+}
+
+void BlockTemplateCache::TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence)
+{
+    LOCK(m_mutex);
+    if (m_template && !m_stale) m_added.push_back(tx.info.m_tx);
+}
+
+void BlockTemplateCache::TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence)
+{
+    // Transactions removed for a block come with a new tip, which is noticed by Get().
+    LOCK(m_mutex);
+    if (m_in_block.count(tx->GetHash())) m_stale = true;
+}
+
+void BlockTemplateCache::Assemble(Chainstate& chainstate, const CScript& script_pub_key)
+{
+    BlockAssembler assembler{chainstate, &m_mempool, m_options};
+    m_template = assembler.CreateNewBlock(script_pub_key);
+    m_tip = chainstate.m_chain.Tip();
+    m_script_pub_key = script_pub_key;
+    m_assembled_time = NodeClock::now();
+    m_stale = false;
+    m_added.clear();
+
+    // Reserve space for the coinbase, like BlockAssembler does.
+    m_block_weight = 4000;
+    m_block_sigops_cost = 400;
+    m_fees = -m_template->vTxFees[0];
+    m_min_package_feerate = assembler.GetMinPackageFeeRate();
+    m_in_block.clear();
+    const std::vector<CTransactionRef>& vtx{m_template->block.vtx};
+    for (size_t i{1}; i < vtx.size(); ++i) {
+        m_in_block.insert(vtx[i]->GetHash());
+        m_block_weight += GetTransactionWeight(*vtx[i]);
+        m_block_sigops_cost += m_template->vTxSigOpsCost[i];
+    }
+}
+
+bool BlockTemplateCache::Append(const CTransaction& tx)
+{
+    // Skip transactions that have left the mempool again, or that were there
+    // already when the template was assembled.
+    const auto it{m_mempool.GetIter(tx.GetHash())};
+    if (!it || m_in_block.count(tx.GetHash())) return true;
+    const CTxMemPoolEntry& entry{**it};
+
+    // A transaction whose parents are not in the template would be selected
+    // together with its ancestors.
+    const auto& parents{entry.GetMemPoolParentsConst()};
+    const bool parents_in_block{std::all_of(parents.begin(), parents.end(), [&](const CTxMemPoolEntry& parent) {
+        return m_in_block.count(parent.GetTx().GetHash()) > 0;
+    })};
+    const uint64_t package_size = parents_in_block ? entry.GetTxSize() : entry.GetSizeWithAncestors();
+    const CAmount package_fees = parents_in_block ? entry.GetModifiedFee() : entry.GetModFeesWithAncestors();
+    const int64_t package_sigops_cost = parents_in_block ? entry.GetSigOpCost() : entry.GetSigOpCostWithAncestors();
+    if (package_fees < m_options.blockMinFeeRate.GetFee(package_size)) {
+        return true;
+    }
+
+    if (m_block_weight + WITNESS_SCALE_FACTOR * package_size >= m_options.nBlockMaxWeight ||
+        m_block_sigops_cost + package_sigops_cost >= MAX_BLOCK_SIGOPS_COST) {
+        // It doesn't fit, so it would only be selected instead of packages of a lower feerate.
+        return m_min_package_feerate && !(*m_min_package_feerate < CFeeRate{package_fees, static_cast<uint32_t>(package_size)});
+    }
+    if (!parents_in_block) return false;
+    if (!IsFinalTx(tx, m_tip->nHeight + 1, m_tip->GetMedianTimePast())) return true;
+
+    m_template->block.vtx.emplace_back(entry.GetSharedTx());
+    m_template->vTxFees.push_back(entry.GetFee());
+    m_template->vTxSigOpsCost.push_back(entry.GetSigOpCost());
+    m_block_weight += entry.GetTxWeight();
+    m_block_sigops_cost += entry.GetSigOpCost();
+    m_fees += entry.GetFee();
+    m_in_block.insert(tx.GetHash());
+    return true;
+}
+
+void BlockTemplateCache::UpdateCoinbase(const CScript& script_pub_key)
+{
+    const int height{m_tip->nHeight + 1};
+    CBlock& block{m_template->block};
+    block.vtx[0] = CreateCoinbaseTx(script_pub_key, height, m_fees + GetBlockSubsidy(height, m_chainman.GetConsensus()));
+    m_template->vchCoinbaseCommitment = m_chainman.GenerateCoinbaseCommitment(block, m_tip);
+    m_template->vTxFees[0] = -m_fees;
+    m_template->vTxSigOpsCost[0] = WITNESS_SCALE_FACTOR * GetLegacySigOpCount(*block.vtx[0]);
+    m_script_pub_key = script_pub_key;
+}
 } // namespace node
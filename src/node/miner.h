@@ -6,13 +6,21 @@
 #ifndef BITCOIN_NODE_MINER_H
 #define BITCOIN_NODE_MINER_H
 
+#include <policy/feerate.h>
 #include <policy/policy.h>
 #include <primitives/block.h>
+#include <script/script.h>
+#include <sync.h>
 #include <txmempool.h>
+#include <util/time.h>
+#include <validationinterface.h>
 
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <stdint.h>
+#include <unordered_set>
+#include <vector>
 
 #include <boost/multi_index/identity.hpp>
 #include <boost/multi_index/indexed_by.hpp>
@@ -143,6 +151,7 @@ private:
     uint64_t nBlockSigOpsCost;
     CAmount nFees;
     std::unordered_set<Txid, SaltedTxidHasher> inBlock;
+    std::optional<CFeeRate> m_min_package_feerate;
 
     // Chain context for the block
     int nHeight;
@@ -170,6 +179,9 @@ public:
     inline static std::optional<int64_t> m_last_block_num_txs{};
     inline static std::optional<int64_t> m_last_block_weight{};
 
+    /** Lowest feerate of the packages added to the last block, if any were added */
+    std::optional<CFeeRate> GetMinPackageFeeRate() const { return m_min_package_feerate; }
+
 private:
     const Options m_options;
 
@@ -199,6 +211,67 @@ private:
     void SortForBlock(const CTxMemPool::setEntries& package, std::vector<CTxMemPool::txiter>& sortedEntries);
 };
 
+/**
+ * Block template that is kept up to date with the mempool, so that it does not
+ * have to be assembled again whenever the mempool changed.
+ *
+ * Transactions that enter the mempool are appended to the template when
+ * assembling a new one would include them too: their parents are in the
+ * template already and they fit. A new tip, the removal of a template
+ * transaction, or a transaction that would displace lower feerate packages
+ * make Get() assemble a new template instead, at most once per
+ * ASSEMBLE_INTERVAL on the same tip.
+ */
+class BlockTemplateCache final : public CValidationInterface
+{
+public:
+    //! Minimum time between assembling templates on the same tip
+    static constexpr std::chrono::seconds ASSEMBLE_INTERVAL{5};
+
+    explicit BlockTemplateCache(ChainstateManager& chainman, const CTxMemPool& mempool);
+    explicit BlockTemplateCache(ChainstateManager& chainman, const CTxMemPool& mempool, const BlockAssembler::Options& options);
+
+    /**
+     * Return the template on the active tip, with a coinbase paying to
+     * script_pub_key. It is updated in place by later calls.
+     */
+    std::shared_ptr<CBlockTemplate> Get(const CScript& script_pub_key) EXCLUSIVE_LOCKS_REQUIRED(::cs_main, !m_mutex);
+
+    /** Assemble a new template on the next Get(), e.g. because fee deltas changed. */
+    void Reset() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+protected:
+    void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    ChainstateManager& m_chainman;
+    const CTxMemPool& m_mempool;
+    const BlockAssembler::Options m_options;
+
+    Mutex m_mutex;
+    std::shared_ptr<CBlockTemplate> m_template GUARDED_BY(m_mutex);
+    const CBlockIndex* m_tip GUARDED_BY(m_mutex){nullptr};
+    CScript m_script_pub_key GUARDED_BY(m_mutex);
+    NodeClock::time_point m_assembled_time GUARDED_BY(m_mutex);
+    //! Whether a change of the mempool requires assembling a new template
+    bool m_stale GUARDED_BY(m_mutex){false};
+    //! Transactions that entered the mempool since the last Get()
+    std::vector<CTransactionRef> m_added GUARDED_BY(m_mutex);
+
+    // State of the template, as kept by BlockAssembler while assembling it
+    std::unordered_set<Txid, SaltedTxidHasher> m_in_block GUARDED_BY(m_mutex);
+    uint64_t m_block_weight GUARDED_BY(m_mutex){0};
+    uint64_t m_block_sigops_cost GUARDED_BY(m_mutex){0};
+    CAmount m_fees GUARDED_BY(m_mutex){0};
+    std::optional<CFeeRate> m_min_package_feerate GUARDED_BY(m_mutex);
+
+    void Assemble(Chainstate& chainstate, const CScript& script_pub_key) EXCLUSIVE_LOCKS_REQUIRED(::cs_main, m_mutex);
+    /** Append a new mempool transaction if needed. Returns false if a new template must be assembled instead. */
+    bool Append(const CTransaction& tx) EXCLUSIVE_LOCKS_REQUIRED(m_mutex, m_mempool.cs);
+    void UpdateCoinbase(const CScript& script_pub_key) EXCLUSIVE_LOCKS_REQUIRED(::cs_main, m_mutex);
+};
+
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
 
 /** Update an old GenerateCoinbaseCommitment from CreateNewBlock after the block txs have changed */
@@ -22,6 +22,14 @@ void ApplyArgsManOptions(const ArgsManager& argsman, PeerManager::Options& optio
 
     if (auto value{argsman.GetBoolArg("-capturemessages")}) options.capture_messages = *value;
 
+    if (auto value{argsman.GetIntArg("-getdatathreads")}) {
+        options.getdata_threads = int(std::clamp<int64_t>(*value, 0, MAX_GETDATA_THREADS));
+    }
+
+    if (auto value{argsman.GetIntArg("-blockhashthreads")}) {
+        options.block_hash_threads = int(std::clamp<int64_t>(*value, 0, MAX_BLOCK_HASH_THREADS));
+    }
+
     if (auto value{argsman.GetBoolArg("-blocksonly")}) options.ignore_incoming_txs = *value;
 }
 
@@ -0,0 +1 @@
+#define BUILD_GIT_COMMIT "5f29f04dba27-dirty"
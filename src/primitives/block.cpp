@@ -8,6 +8,53 @@
 #include <hash.h>
 #include <tinyformat.h>
 
+std::vector<CTransactionRef> MakeHashedTransactions(std::vector<CMutableTransaction>&& txs, const std::vector<unsigned char>& raw, const std::vector<size_t>& ends, const TxHashBatchFn& hash_batch)
+{
+    // The wtxid preimage of a transaction is its serialization. For transactions with witnesses,
+    // the txid preimage leaves out the marker and flag bytes after the version, and the witnesses
+    // before the locktime; it is assembled in stripped. Otherwise both hashes are the same.
+    std::vector<unsigned char> stripped;
+    std::vector<size_t> stripped_ends;
+    for (size_t i = 0; i < txs.size(); ++i) {
+        if (!txs[i].HasWitness()) continue;
+        const size_t begin = i ? ends[i - 1] : 0;
+        size_t witness_size = 0;
+        for (const CTxIn& txin : txs[i].vin) witness_size += GetSerializeSize(txin.scriptWitness.stack);
+        const auto tx_raw = raw.begin() + begin;
+        const size_t size = ends[i] - begin;
+        stripped.insert(stripped.end(), tx_raw, tx_raw + 4);
+        stripped.insert(stripped.end(), tx_raw + 6, tx_raw + size - 4 - witness_size);
+        stripped.insert(stripped.end(), tx_raw + size - 4, tx_raw + size);
+        stripped_ends.push_back(stripped.size());
+    }
+
+    const size_t count = txs.size() + stripped_ends.size();
+    std::vector<const unsigned char*> inputs(count);
+    std::vector<size_t> lengths(count);
+    for (size_t i = 0; i < txs.size(); ++i) {
+        const size_t begin = i ? ends[i - 1] : 0;
+        inputs[i] = raw.data() + begin;
+        lengths[i] = ends[i] - begin;
+    }
+    for (size_t j = 0; j < stripped_ends.size(); ++j) {
+        const size_t begin = j ? stripped_ends[j - 1] : 0;
+        inputs[txs.size() + j] = stripped.data() + begin;
+        lengths[txs.size() + j] = stripped_ends[j] - begin;
+    }
+    std::vector<unsigned char> hashes(32 * count);
+    hash_batch(hashes.data(), inputs.data(), lengths.data(), count);
+
+    std::vector<CTransactionRef> vtx;
+    vtx.reserve(txs.size());
+    size_t next_stripped = txs.size();
+    for (size_t i = 0; i < txs.size(); ++i) {
+        const uint256 wtxid{Span{hashes}.subspan(32 * i, 32)};
+        const uint256 txid{txs[i].HasWitness() ? uint256{Span{hashes}.subspan(32 * next_stripped++, 32)} : wtxid};
+        vtx.push_back(std::make_shared<const CTransaction>(std::move(txs[i]), Txid::FromUint256(txid), Wtxid::FromUint256(wtxid)));
+    }
+    return vtx;
+}
+
 uint256 CBlockHeader::GetHash() const
 {
     return (HashWriter{} << *this).GetHash();
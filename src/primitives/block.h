@@ -6,11 +6,16 @@
 #ifndef BITCOIN_PRIMITIVES_BLOCK_H
 #define BITCOIN_PRIMITIVES_BLOCK_H
 
+#include <consensus/consensus.h>
+#include <crypto/sha256.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
 #include <uint256.h>
 #include <util/time.h>
 
+#include <functional>
+#include <vector>
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -65,6 +70,62 @@ public:
 };
 
 
+/** Double-SHA256 a batch of messages, with the semantics of SHA256DMany. */
+using TxHashBatchFn = std::function<void(unsigned char* output, const unsigned char* const* inputs, const size_t* lengths, size_t count)>;
+
+/** Reads from a stream, appending all bytes read to a buffer. */
+template <typename Source>
+class RecordingReader
+{
+    Source& m_source;
+    std::vector<unsigned char>& m_buffer;
+
+public:
+    RecordingReader(Source& source LIFETIMEBOUND, std::vector<unsigned char>& buffer LIFETIMEBOUND) : m_source{source}, m_buffer{buffer} {}
+
+    void read(Span<std::byte> dst)
+    {
+        m_source.read(dst);
+        m_buffer.insert(m_buffer.end(), UCharCast(dst.data()), UCharCast(dst.data() + dst.size()));
+    }
+
+    template <typename T>
+    RecordingReader& operator>>(T&& obj)
+    {
+        ::Unserialize(*this, obj);
+        return *this;
+    }
+};
+
+/** Turn deserialized transactions into CTransactions, computing their txids and wtxids from the
+ *  serialized bytes they were read from (the concatenation of all transactions in raw, the i-th
+ *  one ending at ends[i]) in a single batch. */
+std::vector<CTransactionRef> MakeHashedTransactions(std::vector<CMutableTransaction>&& txs, const std::vector<unsigned char>& raw, const std::vector<size_t>& ends, const TxHashBatchFn& hash_batch);
+
+/** Deserialize the transactions of a block. Unlike deserializing them one by one, this does not
+ *  reserialize every transaction to compute its hashes, and lets the caller decide how the hashes
+ *  of all transactions are computed, e.g. on several threads. */
+template <typename Stream>
+void UnserializeBlockTransactions(Stream& s, std::vector<CTransactionRef>& vtx, const TxHashBatchFn& hash_batch)
+{
+    const TransactionSerParams& params = s.GetParams();
+    const uint64_t count = ReadCompactSize(s);
+    // Reserve for the number of transactions a valid block can hold at most, so that a bogus
+    // count cannot make us allocate much memory.
+    const size_t reserve{size_t(std::min<uint64_t>(count, MAX_BLOCK_WEIGHT / MIN_TRANSACTION_WEIGHT))};
+    std::vector<CMutableTransaction> txs;
+    txs.reserve(reserve);
+    std::vector<unsigned char> raw;
+    std::vector<size_t> ends;
+    ends.reserve(reserve);
+    RecordingReader reader{s, raw};
+    for (uint64_t i = 0; i < count; ++i) {
+        UnserializeTransaction(txs.emplace_back(), reader, params);
+        ends.push_back(raw.size());
+    }
+    vtx = MakeHashedTransactions(std::move(txs), raw, ends, hash_batch);
+}
+
 class CBlock : public CBlockHeader
 {
 public:
@@ -85,9 +146,17 @@ public:
         *(static_cast<CBlockHeader*>(this)) = header;
     }
 
-    SERIALIZE_METHODS(CBlock, obj)
+    template <typename Stream>
+    void Serialize(Stream& s) const
     {
-        READWRITE(AsBase<CBlockHeader>(obj), obj.vtx);
+        s << AsBase<CBlockHeader>(*this) << vtx;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        s >> AsBase<CBlockHeader>(*this);
+        UnserializeBlockTransactions(s, vtx, SHA256DMany);
     }
 
     void SetNull()
@@ -112,6 +181,15 @@ public:
     std::string ToString() const;
 };
 
+/** Deserialize a block like `s >> block`, computing the hashes of its transactions with
+ *  hash_batch (see UnserializeBlockTransactions). */
+template <typename Stream>
+void UnserializeBlock(Stream& s, CBlock& block, const TxHashBatchFn& hash_batch)
+{
+    s >> AsBase<CBlockHeader>(block);
+    UnserializeBlockTransactions(s, block.vtx, hash_batch);
+}
+
 /** Describes a place in the block chain to another node such that if the
  * other node doesn't have the same branch, it can find a recent common trunk.
  * The further back it is, the further before the fork it may be.
@@ -323,6 +323,9 @@ public:
     /** Convert a CMutableTransaction into a CTransaction. */
     explicit CTransaction(const CMutableTransaction& tx);
     explicit CTransaction(CMutableTransaction&& tx);
+    /** Convert a CMutableTransaction into a CTransaction, using hashes the caller computed from
+     *  its serialization (see UnserializeBlockTransactions) instead of reserializing it. */
+    explicit CTransaction(CMutableTransaction&& tx, const Txid& hash, const Wtxid& witness_hash);
 
     template <typename Stream>
     inline void Serialize(Stream& s) const {
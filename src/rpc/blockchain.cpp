@@ -8,6 +8,7 @@
 #include <blockfilter.h>
 #include <chain.h>
 #include <chainparams.h>
+#include <checkqueue.h>
 #include <clientversion.h>
 #include <coins.h>
 #include <common/args.h>
@@ -20,6 +21,7 @@
 #include <hash.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scriptindex.h>
 #include <kernel/coinstats.h>
 #include <logging/timer.h>
 #include <net.h>
@@ -41,6 +43,7 @@
 #include <univalue.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/hasher.h>
 #include <util/strencodings.h>
 #include <util/translation.h>
 #include <validation.h>
@@ -51,8 +54,11 @@
 #include <stdint.h>
 
 #include <condition_variable>
+#include <exception>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 using kernel::CCoinsStats;
 using kernel::CoinStatsHashType;
@@ -757,6 +763,48 @@ static RPCHelpMan getblock()
     };
 }
 
+static RPCHelpMan getblockcacheinfo()
+{
+    return RPCHelpMan{"getblockcacheinfo",
+                "\nReturns statistics of the cache of recently read blocks (see -blockcachesize).\n"
+                "Serialized blocks are served to peers, deserialized ones to RPC, REST and peers that don't support segwit.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::BOOL, "enabled", "Whether the cache is enabled"},
+                        {RPCResult::Type::NUM, "usage", "Memory used by the cached blocks, in bytes"},
+                        {RPCResult::Type::NUM, "max_usage", "Memory limit of the cache, in bytes"},
+                        {RPCResult::Type::NUM, "entries", "Number of cached blocks"},
+                        {RPCResult::Type::NUM, "raw_hits", "Number of serialized block reads served from the cache"},
+                        {RPCResult::Type::NUM, "raw_misses", "Number of serialized block reads that went to disk"},
+                        {RPCResult::Type::NUM, "block_hits", "Number of deserialized block reads served from the cache"},
+                        {RPCResult::Type::NUM, "block_misses", "Number of deserialized block reads that went to disk"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getblockcacheinfo", "")
+            + HelpExampleRpc("getblockcacheinfo", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    const auto stats{chainman.m_blockman.GetBlockCacheStats()};
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("enabled", stats.has_value());
+    const node::BlockCache::Stats s{stats.value_or(node::BlockCache::Stats{})};
+    ret.pushKV("usage", uint64_t(s.usage));
+    ret.pushKV("max_usage", uint64_t(s.max_usage));
+    ret.pushKV("entries", uint64_t(s.entries));
+    ret.pushKV("raw_hits", s.raw_hits);
+    ret.pushKV("raw_misses", s.raw_misses);
+    ret.pushKV("block_hits", s.block_hits);
+    ret.pushKV("block_misses", s.block_misses);
+    return ret;
+},
+    };
+}
+
 static RPCHelpMan pruneblockchain()
 {
     return RPCHelpMan{"pruneblockchain", "",
@@ -837,7 +885,8 @@ static std::optional<kernel::CCoinsStats> GetUTXOStats(CCoinsView* view, node::B
                                                        kernel::CoinStatsHashType hash_type,
                                                        const std::function<void()>& interruption_point = {},
                                                        const CBlockIndex* pindex = nullptr,
-                                                       bool index_requested = true)
+                                                       bool index_requested = true,
+                                                       int worker_threads_num = 0)
 {
     // Use CoinStatsIndex if it is requested and available and a hash_type of Muhash or None was requested
     if ((hash_type == kernel::CoinStatsHashType::MUHASH || hash_type == kernel::CoinStatsHashType::NONE) && g_coin_stats_index && index_requested) {
@@ -855,7 +904,7 @@ static std::optional<kernel::CCoinsStats> GetUTXOStats(CCoinsView* view, node::B
     // best block.
     CHECK_NONFATAL(!pindex || pindex->GetBlockHash() == view->GetBestBlock());
 
-    return kernel::ComputeUTXOStats(hash_type, view, blockman, interruption_point);
+    return kernel::ComputeUTXOStats(hash_type, view, blockman, interruption_point, worker_threads_num);
 }
 
 static RPCHelpMan gettxoutsetinfo()
@@ -960,7 +1009,7 @@ static RPCHelpMan gettxoutsetinfo()
         }
     }
 
-    const std::optional<CCoinsStats> maybe_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex, index_requested);
+    const std::optional<CCoinsStats> maybe_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex, index_requested, chainman.m_options.worker_threads_num);
     if (maybe_stats.has_value()) {
         const CCoinsStats& stats = maybe_stats.value();
         ret.pushKV("height", (int64_t)stats.nHeight);
@@ -983,7 +1032,7 @@ static RPCHelpMan gettxoutsetinfo()
 
             CCoinsStats prev_stats{};
             if (pindex->nHeight > 0) {
-                const std::optional<CCoinsStats> maybe_prev_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex->pprev, index_requested);
+                const std::optional<CCoinsStats> maybe_prev_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex->pprev, index_requested, chainman.m_options.worker_threads_num);
                 if (!maybe_prev_stats) {
                     throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
                 }
@@ -1993,15 +2042,18 @@ static RPCHelpMan getblockstats()
 }
 
 namespace {
-//! Search for a given set of pubkey scripts
-bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, CCoinsViewCursor* cursor, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
+//! Number of key ranges the UTXO set is split into to be scanned by several threads
+constexpr size_t SCAN_TXOUT_RANGES{256};
+
+using ScriptSet = std::unordered_set<CScript, SaltedSipHasher>;
+
+//! Search a range of the UTXO set for a given set of pubkey scripts
+bool FindScriptPubKeyInRange(const std::atomic<bool>& should_abort, int64_t& count, CCoinsViewCursor& cursor, const ScriptSet& needles, std::map<COutPoint, Coin>& out_results, const std::function<void()>& interruption_point)
 {
-    scan_progress = 0;
-    count = 0;
-    while (cursor->Valid()) {
+    while (cursor.Valid()) {
         COutPoint key;
         Coin coin;
-        if (!cursor->GetKey(key) || !cursor->GetValue(coin)) return false;
+        if (!cursor.GetKey(key) || !cursor.GetValue(coin)) return false;
         if (++count % 8192 == 0) {
             interruption_point();
             if (should_abort) {
@@ -2009,19 +2061,57 @@ bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>&
                 return false;
             }
         }
-        if (count % 256 == 0) {
-            // update progress reference every 256 item
-            uint32_t high = 0x100 * *UCharCast(key.hash.begin()) + *(UCharCast(key.hash.begin()) + 1);
-            scan_progress = (int)(high * 100.0 / 65536.0 + 0.5);
-        }
         if (needles.count(coin.out.scriptPubKey)) {
             out_results.emplace(key, coin);
         }
-        cursor->Next();
+        cursor.Next();
     }
-    scan_progress = 100;
     return true;
 }
+
+//! Search for a given set of pubkey scripts, scanning the ranges of the
+//! cursors on the calling thread and worker_threads_num additional ones
+bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, const std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors, const ScriptSet& needles, std::map<COutPoint, Coin>& out_results, const std::function<void()>& interruption_point, int worker_threads_num)
+{
+    scan_progress = 0;
+    count = 0;
+    std::vector<int64_t> range_counts(cursors.size());
+    std::vector<std::map<COutPoint, Coin>> range_results(cursors.size());
+    std::atomic<size_t> ranges_done{0};
+    // The interruption point throws on shutdown, which must not happen on a
+    // worker thread. The exception is passed on to this thread instead.
+    Mutex exception_mutex;
+    std::exception_ptr exception;
+
+    bool success;
+    {
+        CCheckQueue<std::function<bool()>> queue{/*batch_size=*/1, worker_threads_num, "scantxout"};
+        CCheckQueueControl<std::function<bool()>> control(&queue);
+        for (size_t n = 0; n < cursors.size(); ++n) {
+            control.Add({[&, n] {
+                try {
+                    if (!FindScriptPubKeyInRange(should_abort, range_counts[n], *cursors[n], needles, range_results[n], interruption_point)) return false;
+                } catch (...) {
+                    LOCK(exception_mutex);
+                    if (!exception) exception = std::current_exception();
+                    return false;
+                }
+                scan_progress = int(++ranges_done * 100 / cursors.size());
+                return true;
+            }});
+        }
+        success = control.Wait();
+    }
+    if (exception) std::rethrow_exception(exception);
+
+    // Ranges are disjoint, so merging them gives the same results as a single scan
+    for (size_t n = 0; n < cursors.size(); ++n) {
+        count += range_counts[n];
+        out_results.merge(range_results[n]);
+    }
+    if (success) scan_progress = 100;
+    return success;
+}
 } // namespace
 
 /** RAII object to prevent concurrency issue when scanning the txout set */
@@ -2176,8 +2266,8 @@ static RPCHelpMan scantxoutset()
             throw JSONRPCError(RPC_MISC_ERROR, "scanobjects argument is required for the start action");
         }
 
-        std::set<CScript> needles;
-        std::map<CScript, std::string> descriptors;
+        ScriptSet needles;
+        std::unordered_map<CScript, std::string, SaltedSipHasher> descriptors;
         CAmount total_in = 0;
 
         // loop through the scan objects
@@ -2197,18 +2287,19 @@ static RPCHelpMan scantxoutset()
         std::map<COutPoint, Coin> coins;
         g_should_abort_scan = false;
         int64_t count = 0;
-        std::unique_ptr<CCoinsViewCursor> pcursor;
+        std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
         const CBlockIndex* tip;
         NodeContext& node = EnsureAnyNodeContext(request.context);
+        ChainstateManager& chainman = EnsureChainman(node);
         {
-            ChainstateManager& chainman = EnsureChainman(node);
             LOCK(cs_main);
             Chainstate& active_chainstate = chainman.ActiveChainstate();
             active_chainstate.ForceFlushStateToDisk();
-            pcursor = CHECK_NONFATAL(active_chainstate.CoinsDB().Cursor());
+            cursors = active_chainstate.CoinsDB().RangeCursors(SCAN_TXOUT_RANGES);
+            CHECK_NONFATAL(!cursors.empty());
             tip = CHECK_NONFATAL(active_chainstate.m_chain.Tip());
         }
-        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, pcursor.get(), needles, coins, node.rpc_interruption_point);
+        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, cursors, needles, coins, node.rpc_interruption_point, chainman.m_options.worker_threads_num);
         result.pushKV("success", res);
         result.pushKV("txouts", count);
         result.pushKV("height", tip->nHeight);
@@ -2483,6 +2574,220 @@ static RPCHelpMan scanblocks()
     };
 }
 
+static const auto script_index_objects_arg_desc = RPCArg{
+    "scanobjects", RPCArg::Type::ARR, RPCArg::Optional::NO, "Array of scan objects\n"
+        "Every scan object is either a string descriptor or an object:",
+    {
+        {"descriptor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "An output descriptor"},
+        {"", RPCArg::Type::OBJ, RPCArg::Optional::OMITTED, "An object with output descriptor and metadata",
+            {
+                {"desc", RPCArg::Type::STR, RPCArg::Optional::NO, "An output descriptor"},
+                {"range", RPCArg::Type::RANGE, RPCArg::Default{1000}, "The range of HD chain indexes to explore (either end or [begin,end])"},
+            }},
+    },
+    RPCArgOptions{.oneline_description="[scanobjects,...]"},
+};
+
+/** Expand the scan objects of a script index lookup, and map each script to its inferred descriptor. */
+static std::map<CScript, std::string> ParseScriptIndexObjects(const UniValue& scanobjects)
+{
+    std::map<CScript, std::string> descriptors;
+    for (const UniValue& scanobject : scanobjects.get_array().getValues()) {
+        FlatSigningProvider provider;
+        for (CScript& script : EvalDescriptorStringOrObject(scanobject, provider)) {
+            std::string inferred = InferDescriptor(script, provider)->ToString();
+            descriptors.emplace(std::move(script), std::move(inferred));
+        }
+    }
+    return descriptors;
+}
+
+/** Wait for the script index to process the current chain tip, and return its state. */
+static IndexSummary EnsureScriptIndexSynced()
+{
+    if (!g_scriptindex) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Script index is not enabled. Use -scriptindex to enable it");
+    }
+    const bool synced{g_scriptindex->BlockUntilSyncedToCurrentChain()};
+    const IndexSummary summary{g_scriptindex->GetSummary()};
+    if (!synced) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, strprintf("Unable to get data because scriptindex is still syncing. Current height: %d", summary.best_block_height));
+    }
+    return summary;
+}
+
+static RPCHelpMan getscripthistory()
+{
+    return RPCHelpMan{"getscripthistory",
+        "\nReturn the confirmed outputs paying to scripts matching the given descriptors, and the inputs spending them (requires scriptindex).\n"
+        "Unlike scantxoutset, this does not scan the UTXO set.\n",
+        {
+            script_index_objects_arg_desc,
+            {"start_height", RPCArg::Type::NUM, RPCArg::Default{0}, "Skip the history of blocks below this height"},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "height", "The height of the block the index is synced to"},
+                {RPCResult::Type::STR_HEX, "bestblock", "The hash of the block the index is synced to"},
+                {RPCResult::Type::ARR, "history", "The entries found, ordered by height",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR, "type", "\"receive\" for an output paying to the script, \"spend\" for an input spending such an output"},
+                        {RPCResult::Type::NUM, "height", "Height of the block containing the transaction"},
+                        {RPCResult::Type::STR_HEX, "txid", "The id of the transaction creating (or spending) the output"},
+                        {RPCResult::Type::NUM, "vout", /*optional=*/true, "The index of the output, for \"receive\" entries"},
+                        {RPCResult::Type::NUM, "vin", /*optional=*/true, "The index of the input spending the output, for \"spend\" entries"},
+                        {RPCResult::Type::STR_HEX, "prevout_txid", /*optional=*/true, "The id of the transaction which created the spent output, for \"spend\" entries"},
+                        {RPCResult::Type::NUM, "prevout_vout", /*optional=*/true, "The index of the spent output, for \"spend\" entries"},
+                        {RPCResult::Type::STR_HEX, "scriptPubKey", "The script"},
+                        {RPCResult::Type::STR, "desc", "A specialized descriptor for the matched scriptPubKey"},
+                        {RPCResult::Type::STR_AMOUNT, "amount", "The amount in " + CURRENCY_UNIT + " of the output"},
+                    }},
+                }},
+            }},
+        RPCExamples{
+            HelpExampleCli("getscripthistory", "'[\"addr(bcrt1q4u4nsgk6ug0sqz7r3rj9tykjxrsl0yy4d0wwte)\"]'") +
+            HelpExampleCli("getscripthistory", "'[\"addr(bcrt1q4u4nsgk6ug0sqz7r3rj9tykjxrsl0yy4d0wwte)\"]' 100") +
+            HelpExampleRpc("getscripthistory", "[\"addr(bcrt1q4u4nsgk6ug0sqz7r3rj9tykjxrsl0yy4d0wwte)\"], 100")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const std::map<CScript, std::string> descriptors{ParseScriptIndexObjects(request.params[0])};
+    const int start_height{request.params[1].isNull() ? 0 : request.params[1].getInt<int>()};
+    if (start_height < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid start_height");
+    }
+    const IndexSummary summary{EnsureScriptIndexSynced()};
+
+    std::vector<std::pair<ScriptHistoryEntry, std::map<CScript, std::string>::const_iterator>> history;
+    for (auto it = descriptors.begin(); it != descriptors.end(); ++it) {
+        std::vector<ScriptHistoryEntry> entries;
+        if (!g_scriptindex->FindScriptHistory(it->first, start_height, entries)) {
+            throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to read the script index");
+        }
+        for (ScriptHistoryEntry& entry : entries) history.emplace_back(std::move(entry), it);
+    }
+    std::stable_sort(history.begin(), history.end(), [](const auto& a, const auto& b) { return a.first.height < b.first.height; });
+
+    UniValue entries(UniValue::VARR);
+    for (const auto& [entry, script] : history) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("type", entry.spending ? "spend" : "receive");
+        obj.pushKV("height", entry.height);
+        if (entry.spending) {
+            obj.pushKV("txid", entry.spending_txid.GetHex());
+            obj.pushKV("vin", (int64_t)entry.spending_vin);
+            obj.pushKV("prevout_txid", entry.outpoint.hash.GetHex());
+            obj.pushKV("prevout_vout", (int64_t)entry.outpoint.n);
+        } else {
+            obj.pushKV("txid", entry.outpoint.hash.GetHex());
+            obj.pushKV("vout", (int64_t)entry.outpoint.n);
+        }
+        obj.pushKV("scriptPubKey", HexStr(script->first));
+        obj.pushKV("desc", script->second);
+        obj.pushKV("amount", ValueFromAmount(entry.amount));
+        entries.push_back(std::move(obj));
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("height", summary.best_block_height);
+    ret.pushKV("bestblock", summary.best_block_hash.GetHex());
+    ret.pushKV("history", std::move(entries));
+    return ret;
+},
+    };
+}
+
+static RPCHelpMan getscriptunspent()
+{
+    return RPCHelpMan{"getscriptunspent",
+        "\nReturn the unspent outputs paying to scripts matching the given descriptors (requires scriptindex).\n"
+        "Unlike scantxoutset, this does not scan the UTXO set.\n",
+        {
+            script_index_objects_arg_desc,
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "height", "The height of the block the index is synced to"},
+                {RPCResult::Type::STR_HEX, "bestblock", "The hash of the block the index is synced to"},
+                {RPCResult::Type::ARR, "unspents", "",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                        {RPCResult::Type::NUM, "vout", "The vout value"},
+                        {RPCResult::Type::STR_HEX, "scriptPubKey", "The script key"},
+                        {RPCResult::Type::STR, "desc", "A specialized descriptor for the matched scriptPubKey"},
+                        {RPCResult::Type::STR_AMOUNT, "amount", "The total amount in " + CURRENCY_UNIT + " of the unspent output"},
+                        {RPCResult::Type::BOOL, "coinbase", "Whether this is a coinbase output"},
+                        {RPCResult::Type::NUM, "height", "Height of the unspent transaction output"},
+                    }},
+                }},
+                {RPCResult::Type::STR_AMOUNT, "total_amount", "The total amount of all found unspent outputs in " + CURRENCY_UNIT},
+            }},
+        RPCExamples{
+            HelpExampleCli("getscriptunspent", "'[\"addr(bcrt1q4u4nsgk6ug0sqz7r3rj9tykjxrsl0yy4d0wwte)\"]'") +
+            HelpExampleRpc("getscriptunspent", "[\"addr(bcrt1q4u4nsgk6ug0sqz7r3rj9tykjxrsl0yy4d0wwte)\"]")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const std::map<CScript, std::string> descriptors{ParseScriptIndexObjects(request.params[0])};
+    const IndexSummary summary{EnsureScriptIndexSynced()};
+
+    // Outputs funded and not spent according to the index are looked up in the
+    // UTXO set, which also rules out those of other scripts with the same id.
+    std::map<COutPoint, std::map<CScript, std::string>::const_iterator> candidates;
+    for (auto it = descriptors.begin(); it != descriptors.end(); ++it) {
+        std::vector<ScriptHistoryEntry> entries;
+        if (!g_scriptindex->FindScriptHistory(it->first, /*start_height=*/0, entries)) {
+            throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to read the script index");
+        }
+        for (const ScriptHistoryEntry& entry : entries) {
+            if (entry.spending) {
+                candidates.erase(entry.outpoint);
+            } else {
+                candidates.emplace(entry.outpoint, it);
+            }
+        }
+    }
+
+    NodeContext& node = EnsureAnyNodeContext(request.context);
+    ChainstateManager& chainman = EnsureChainman(node);
+    UniValue unspents(UniValue::VARR);
+    CAmount total_in{0};
+    {
+        LOCK(cs_main);
+        const CCoinsViewCache& coins_view{chainman.ActiveChainstate().CoinsTip()};
+        for (const auto& [outpoint, script] : candidates) {
+            Coin coin;
+            if (!coins_view.GetCoin(outpoint, coin) || coin.out.scriptPubKey != script->first) continue;
+            total_in += coin.out.nValue;
+
+            UniValue unspent(UniValue::VOBJ);
+            unspent.pushKV("txid", outpoint.hash.GetHex());
+            unspent.pushKV("vout", (int32_t)outpoint.n);
+            unspent.pushKV("scriptPubKey", HexStr(coin.out.scriptPubKey));
+            unspent.pushKV("desc", script->second);
+            unspent.pushKV("amount", ValueFromAmount(coin.out.nValue));
+            unspent.pushKV("coinbase", coin.IsCoinBase());
+            unspent.pushKV("height", (int32_t)coin.nHeight);
+            unspents.push_back(std::move(unspent));
+        }
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("height", summary.best_block_height);
+    ret.pushKV("bestblock", summary.best_block_hash.GetHex());
+    ret.pushKV("unspents", std::move(unspents));
+    ret.pushKV("total_amount", ValueFromAmount(total_in));
+    return ret;
+},
+    };
+}
+
 static RPCHelpMan getblockfilter()
 {
     return RPCHelpMan{"getblockfilter",
@@ -2651,7 +2956,8 @@ UniValue CreateUTXOSnapshot(
 
         chainstate.ForceFlushStateToDisk();
 
-        maybe_stats = GetUTXOStats(&chainstate.CoinsDB(), chainstate.m_blockman, CoinStatsHashType::HASH_SERIALIZED, node.rpc_interruption_point);
+        maybe_stats = GetUTXOStats(&chainstate.CoinsDB(), chainstate.m_blockman, CoinStatsHashType::HASH_SERIALIZED, node.rpc_interruption_point,
+                                   /*pindex=*/nullptr, /*index_requested=*/true, chainstate.m_chainman.m_options.worker_threads_num);
         if (!maybe_stats) {
             throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
         }
@@ -2875,6 +3181,7 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &getbestblockhash},
         {"blockchain", &getblockcount},
         {"blockchain", &getblock},
+        {"blockchain", &getblockcacheinfo},
         {"blockchain", &getblockfrompeer},
         {"blockchain", &getblockhash},
         {"blockchain", &getblockheader},
@@ -2888,6 +3195,8 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &preciousblock},
         {"blockchain", &scantxoutset},
         {"blockchain", &scanblocks},
+        {"blockchain", &getscripthistory},
+        {"blockchain", &getscriptunspent},
         {"blockchain", &getblockfilter},
         {"blockchain", &dumptxoutset},
         {"blockchain", &loadtxoutset},
@@ -93,6 +93,9 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "scanblocks", 5, "options" },
     { "scanblocks", 5, "filter_false_positives" },
     { "scantxoutset", 1, "scanobjects" },
+    { "getscripthistory", 0, "scanobjects" },
+    { "getscripthistory", 1, "start_height" },
+    { "getscriptunspent", 0, "scanobjects" },
     { "addmultisigaddress", 0, "nrequired" },
     { "addmultisigaddress", 1, "keys" },
     { "createmultisig", 0, "nrequired" },
@@ -259,6 +262,9 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getmempoolancestors", 1, "verbose" },
     { "getmempooldescendants", 1, "verbose" },
     { "gettxspendingprevout", 0, "outputs" },
+    { "gettxspendingprevout", 1, "options" },
+    { "gettxspendingprevout", 1, "mempool_only" },
+    { "gettxspendingprevout", 1, "return_spending_tx" },
     { "bumpfee", 1, "options" },
     { "bumpfee", 1, "conf_target"},
     { "bumpfee", 1, "fee_rate"},
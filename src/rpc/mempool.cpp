@@ -9,6 +9,7 @@
 
 #include <chainparams.h>
 #include <core_io.h>
+#include <index/txospenderindex.h>
 #include <kernel/mempool_entry.h>
 #include <node/mempool_persist_args.h>
 #include <policy/rbf.h>
@@ -21,6 +22,7 @@
 #include <univalue.h>
 #include <util/fs.h>
 #include <util/moneystr.h>
+#include <util/result.h>
 #include <util/strencodings.h>
 #include <util/time.h>
 
@@ -581,7 +583,7 @@ static RPCHelpMan getmempoolentry()
 static RPCHelpMan gettxspendingprevout()
 {
     return RPCHelpMan{"gettxspendingprevout",
-        "Scans the mempool to find transactions spending any of the given outputs",
+        "Scans the mempool (and the txospenderindex, if enabled) to find transactions spending any of the given outputs",
         {
             {"outputs", RPCArg::Type::ARR, RPCArg::Optional::NO, "The transaction outputs that we want to check, and within each, the txid (string) vout (numeric).",
                 {
@@ -593,6 +595,12 @@ static RPCHelpMan gettxspendingprevout()
                     },
                 },
             },
+            {"options", RPCArg::Type::OBJ_NAMED_PARAMS, RPCArg::Optional::OMITTED, "",
+                {
+                    {"mempool_only", RPCArg::Type::BOOL, RPCArg::DefaultHint{"true if txospenderindex unavailable, otherwise false"}, "If false, outputs without a spend in the mempool are looked up in the txospenderindex (which must be enabled)"},
+                    {"return_spending_tx", RPCArg::Type::BOOL, RPCArg::Default{false}, "Whether to return the spending transactions"},
+                },
+                RPCArgOptions{.oneline_description="options"}},
         },
         RPCResult{
             RPCResult::Type::ARR, "", "",
@@ -601,7 +609,9 @@ static RPCHelpMan gettxspendingprevout()
                 {
                     {RPCResult::Type::STR_HEX, "txid", "the transaction id of the checked output"},
                     {RPCResult::Type::NUM, "vout", "the vout value of the checked output"},
-                    {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the mempool transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::STR_HEX, "spendingtx", /*optional=*/true, "the serialized, hex-encoded spending transaction (only if return_spending_tx is set, omitted if unspent)"},
+                    {RPCResult::Type::STR_HEX, "blockhash", /*optional=*/true, "the hash of the block containing the spending transaction (omitted if unspent or spent in the mempool)"},
                 }},
             }
         },
@@ -637,24 +647,73 @@ static RPCHelpMan gettxspendingprevout()
                 prevouts.emplace_back(txid, nOutput);
             }
 
-            const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-            LOCK(mempool.cs);
-
-            UniValue result{UniValue::VARR};
+            const UniValue options{request.params[1].isNull() ? UniValue::VOBJ : request.params[1]};
+            RPCTypeCheckObj(options,
+                            {
+                                {"mempool_only", UniValueType(UniValue::VBOOL)},
+                                {"return_spending_tx", UniValueType(UniValue::VBOOL)},
+                            }, /*fAllowNull=*/true, /*fStrict=*/true);
+            const bool mempool_only{options.exists("mempool_only") ? options["mempool_only"].get_bool() : !g_txospenderindex};
+            const bool return_spending_tx{options.exists("return_spending_tx") ? options["return_spending_tx"].get_bool() : false};
+
+            if (!mempool_only) {
+                if (!g_txospenderindex) {
+                    throw JSONRPCError(RPC_MISC_ERROR, "Spent output index is not enabled. Use -txospenderindex to enable it");
+                }
+                if (!g_txospenderindex->BlockUntilSyncedToCurrentChain()) {
+                    throw JSONRPCError(RPC_INTERNAL_ERROR, strprintf("Unable to get data because txospenderindex is still syncing. Current height: %d", g_txospenderindex->GetSummary().best_block_height));
+                }
+            }
 
-            for (const COutPoint& prevout : prevouts) {
-                UniValue o(UniValue::VOBJ);
-                o.pushKV("txid", prevout.hash.ToString());
-                o.pushKV("vout", (uint64_t)prevout.n);
+            std::vector<UniValue> results;
+            // Outputs not spent in the mempool, by index in results
+            std::vector<size_t> not_in_mempool;
+            {
+                const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
+                LOCK(mempool.cs);
+
+                for (const COutPoint& prevout : prevouts) {
+                    UniValue o(UniValue::VOBJ);
+                    o.pushKV("txid", prevout.hash.ToString());
+                    o.pushKV("vout", (uint64_t)prevout.n);
+
+                    const CTransaction* spendingTx = mempool.GetConflictTx(prevout);
+                    if (spendingTx != nullptr) {
+                        o.pushKV("spendingtxid", spendingTx->GetHash().ToString());
+                        if (return_spending_tx) {
+                            o.pushKV("spendingtx", EncodeHexTx(*spendingTx));
+                        }
+                    } else {
+                        not_in_mempool.push_back(results.size());
+                    }
 
-                const CTransaction* spendingTx = mempool.GetConflictTx(prevout);
-                if (spendingTx != nullptr) {
-                    o.pushKV("spendingtxid", spendingTx->GetHash().ToString());
+                    results.push_back(std::move(o));
                 }
+            }
 
-                result.push_back(o);
+            // Look up the confirmed spends without holding the mempool lock, as
+            // this reads the spending transactions from disk.
+            if (!mempool_only) {
+                for (const size_t i : not_in_mempool) {
+                    const auto spender{g_txospenderindex->FindSpender(prevouts[i])};
+                    if (!spender) {
+                        throw JSONRPCError(RPC_MISC_ERROR, util::ErrorString(spender).original);
+                    }
+                    if (*spender) {
+                        const TxoSpender& confirmed{**spender};
+                        results[i].pushKV("spendingtxid", confirmed.tx->GetHash().ToString());
+                        if (return_spending_tx) {
+                            results[i].pushKV("spendingtx", EncodeHexTx(*confirmed.tx));
+                        }
+                        results[i].pushKV("blockhash", confirmed.block_hash.ToString());
+                    }
+                }
             }
 
+            UniValue result{UniValue::VARR};
+            for (UniValue& o : results) {
+                result.push_back(std::move(o));
+            }
             return result;
         },
     };
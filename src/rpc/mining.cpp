@@ -45,6 +45,7 @@
 #include <stdint.h>
 
 using node::BlockAssembler;
+using node::BlockTemplateCache;
 using node::CBlockTemplate;
 using node::NodeContext;
 using node::RegenerateCommitments;
@@ -487,7 +488,9 @@ static RPCHelpMan prioritisetransaction()
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Priority is no longer supported, dummy argument to prioritisetransaction must be 0.");
     }
 
-    EnsureAnyMemPool(request.context).PrioritiseTransaction(hash, nAmount);
+    NodeContext& node = EnsureAnyNodeContext(request.context);
+    EnsureMemPool(node).PrioritiseTransaction(hash, nAmount);
+    if (node.block_template_cache) node.block_template_cache->Reset();
     return true;
 },
     };
@@ -551,6 +554,15 @@ static UniValue BIP22ValidationResult(const BlockValidationState& state)
     return "valid?";
 }
 
+static BlockTemplateCache& EnsureBlockTemplateCache(NodeContext& node) EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+{
+    if (!node.block_template_cache) {
+        node.block_template_cache = std::make_unique<BlockTemplateCache>(EnsureChainman(node), EnsureMemPool(node));
+        RegisterValidationInterface(node.block_template_cache.get());
+    }
+    return *node.block_template_cache;
+}
+
 static std::string gbt_vb_name(const Consensus::DeploymentPos pos) {
     const struct VBDeploymentInfo& vbinfo = VersionBitsDeploymentInfo[pos];
     std::string s = vbinfo.name;
@@ -790,30 +802,11 @@ static RPCHelpMan getblocktemplate()
         throw JSONRPCError(RPC_INVALID_PARAMETER, "getblocktemplate must be called with the segwit rule set (call with {\"rules\": [\"segwit\"]})");
     }
 
-    // Update block
-    static CBlockIndex* pindexPrev;
-    static int64_t time_start;
-    static std::unique_ptr<CBlockTemplate> pblocktemplate;
-    if (pindexPrev != active_chain.Tip() ||
-        (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - time_start > 5))
-    {
-        // Clear pindexPrev so future calls make a new block, despite any failures from here on
-        pindexPrev = nullptr;
-
-        // Store the pindexBest used before CreateNewBlock, to avoid races
-        nTransactionsUpdatedLast = mempool.GetTransactionsUpdated();
-        CBlockIndex* pindexPrevNew = active_chain.Tip();
-        time_start = GetTime();
-
-        // Create new block
-        CScript scriptDummy = CScript() << OP_TRUE;
-        pblocktemplate = BlockAssembler{active_chainstate, &mempool}.CreateNewBlock(scriptDummy);
-        if (!pblocktemplate)
-            throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
-
-        // Need to update only after we know CreateNewBlock succeeded
-        pindexPrev = pindexPrevNew;
-    }
+    // Update block, from the mempool changes since the previous call where possible
+    nTransactionsUpdatedLast = mempool.GetTransactionsUpdated();
+    CScript scriptDummy = CScript() << OP_TRUE;
+    const std::shared_ptr<CBlockTemplate> pblocktemplate{EnsureBlockTemplateCache(node).Get(scriptDummy)};
+    const CBlockIndex* const pindexPrev{active_chain.Tip()};
     CHECK_NONFATAL(pindexPrev);
     CBlock* pblock = &pblocktemplate->block; // pointer for convenience
 
@@ -0,0 +1,128 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <core_memusage.h>
+#include <flatfile.h>
+#include <memusage.h>
+#include <node/blockcache.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using node::BlockCache;
+
+BOOST_FIXTURE_TEST_SUITE(blockcache_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(blockcache_hits_and_misses)
+{
+    BlockCache cache{1 << 20};
+    const FlatFilePos pos{0, 8};
+
+    BOOST_CHECK(!cache.GetRaw(pos));
+    BOOST_CHECK(!cache.GetBlock(pos));
+
+    auto raw{std::make_shared<const std::vector<uint8_t>>(100, 0xab)};
+    cache.PutRaw(pos, raw);
+    BOOST_CHECK(cache.GetRaw(pos) == raw);
+    // Only the serialized block is cached so far
+    BOOST_CHECK(!cache.GetBlock(pos));
+
+    CBlock block;
+    block.nVersion = 2;
+    auto shared_block{std::make_shared<const CBlock>(block)};
+    cache.PutBlock(pos, shared_block);
+    BOOST_CHECK(cache.GetBlock(pos) == shared_block);
+    BOOST_CHECK(cache.GetRaw(pos) == raw);
+
+    const auto stats{cache.GetStats()};
+    BOOST_CHECK_EQUAL(stats.entries, 1U);
+    BOOST_CHECK_EQUAL(stats.usage, memusage::DynamicUsage(*raw) + RecursiveDynamicUsage(block));
+    BOOST_CHECK_EQUAL(stats.max_usage, 1U << 20);
+    BOOST_CHECK_EQUAL(stats.raw_hits, 2U);
+    BOOST_CHECK_EQUAL(stats.raw_misses, 1U);
+    BOOST_CHECK_EQUAL(stats.block_hits, 1U);
+    BOOST_CHECK_EQUAL(stats.block_misses, 2U);
+}
+
+BOOST_AUTO_TEST_CASE(blockcache_eviction)
+{
+    constexpr size_t RAW_SIZE{1000};
+    const size_t raw_usage{memusage::DynamicUsage(std::vector<uint8_t>(RAW_SIZE))};
+    // Room for ten blocks per shard
+    BlockCache cache{BlockCache::NUM_SHARDS * raw_usage * 10};
+
+    for (unsigned int i{0}; i < 1000; ++i) {
+        cache.PutRaw(FlatFilePos{0, i}, std::make_shared<const std::vector<uint8_t>>(RAW_SIZE));
+        // Keep using the first block, so that it is never the least recently used one
+        BOOST_CHECK(cache.GetRaw(FlatFilePos{0, 0}));
+    }
+    const auto stats{cache.GetStats()};
+    BOOST_CHECK(stats.usage <= stats.max_usage);
+    BOOST_CHECK(stats.entries <= BlockCache::NUM_SHARDS * 10);
+    BOOST_CHECK(stats.entries > 0);
+    // The most recently added block is still there, the oldest ones are gone
+    BOOST_CHECK(cache.GetRaw(FlatFilePos{0, 999}));
+    BOOST_CHECK(!cache.GetRaw(FlatFilePos{0, 1}));
+
+    // A block larger than a shard's share of the limit is not kept
+    cache.PutRaw(FlatFilePos{1, 0}, std::make_shared<const std::vector<uint8_t>>(RAW_SIZE * 11));
+    BOOST_CHECK(!cache.GetRaw(FlatFilePos{1, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(blockcache_erase_file)
+{
+    BlockCache cache{1 << 20};
+    for (int file{0}; file < 3; ++file) {
+        for (unsigned int i{0}; i < 10; ++i) {
+            cache.PutRaw(FlatFilePos{file, i}, std::make_shared<const std::vector<uint8_t>>(10));
+        }
+    }
+    BOOST_CHECK_EQUAL(cache.GetStats().entries, 30U);
+    cache.EraseFile(1);
+    BOOST_CHECK_EQUAL(cache.GetStats().entries, 20U);
+    for (unsigned int i{0}; i < 10; ++i) {
+        BOOST_CHECK(cache.GetRaw(FlatFilePos{0, i}));
+        BOOST_CHECK(!cache.GetRaw(FlatFilePos{1, i}));
+        BOOST_CHECK(cache.GetRaw(FlatFilePos{2, i}));
+    }
+}
+
+struct BlockCacheTestingSetup : public TestChain100Setup {
+    BlockCacheTestingSetup() : TestChain100Setup{ChainType::REGTEST, {"-blockcachesize=8"}} {}
+};
+
+BOOST_FIXTURE_TEST_CASE(blockcache_blockmanager, BlockCacheTestingSetup)
+{
+    const node::BlockManager& blockman{m_node.chainman->m_blockman};
+    const CBlockIndex& tip{*WITH_LOCK(::cs_main, return m_node.chainman->ActiveTip())};
+    const FlatFilePos pos{WITH_LOCK(::cs_main, return tip.GetBlockPos())};
+    const auto stats_before{blockman.GetBlockCacheStats()};
+    BOOST_REQUIRE(stats_before);
+    BOOST_CHECK_EQUAL(stats_before->max_usage, 8U << 20);
+
+    CBlock block1, block2;
+    BOOST_CHECK(blockman.ReadBlockFromDisk(block1, tip));
+    BOOST_CHECK(blockman.ReadBlockFromDisk(block2, tip));
+    BOOST_CHECK_EQUAL(block1.GetHash(), tip.GetBlockHash());
+    BOOST_CHECK_EQUAL(block2.GetHash(), tip.GetBlockHash());
+    std::vector<uint8_t> raw1, raw2;
+    BOOST_CHECK(blockman.ReadRawBlockFromDisk(raw1, pos));
+    BOOST_CHECK(blockman.ReadRawBlockFromDisk(raw2, pos));
+    BOOST_CHECK(raw1 == raw2);
+
+    const auto stats{blockman.GetBlockCacheStats()};
+    BOOST_CHECK_EQUAL(stats->block_hits, stats_before->block_hits + 1);
+    BOOST_CHECK_EQUAL(stats->raw_hits, stats_before->raw_hits + 1);
+    BOOST_CHECK_EQUAL(stats->raw_misses, stats_before->raw_misses + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <test/data/blockfilters.json.h>
+#include <test/util/random.h>
 #include <test/util/setup_common.h>
 
 #include <blockfilter.h>
@@ -12,6 +13,7 @@
 #include <streams.h>
 #include <undo.h>
 #include <univalue.h>
+#include <util/golombrice.h>
 #include <util/strencodings.h>
 
 #include <boost/test/unit_test.hpp>
@@ -41,6 +43,78 @@ BOOST_AUTO_TEST_CASE(gcsfilter_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(golombrice_reader_test)
+{
+    for (const uint8_t P : {0, 1, 19, 40}) {
+        std::vector<uint64_t> values;
+        std::vector<unsigned char> encoded;
+        {
+            VectorWriter stream{encoded, 0};
+            BitStreamWriter bitwriter{stream};
+            for (int i = 0; i < 200; ++i) {
+                // Quotients of up to 200 cross several 64-bit words.
+                values.push_back((InsecureRandRange(i < 10 ? 200 : 4) << P) | (P ? InsecureRandBits(P) : 0));
+                GolombRiceEncode(bitwriter, P, values.back());
+            }
+            bitwriter.Flush();
+        }
+
+        GolombRiceReader reader{encoded};
+        SpanReader stream{encoded};
+        BitStreamReader bitreader{stream};
+        for (const uint64_t value : values) {
+            BOOST_CHECK_EQUAL(reader.Decode(P), value);
+            BOOST_CHECK_EQUAL(GolombRiceDecode(bitreader, P), value);
+        }
+        BOOST_CHECK_EQUAL(reader.BytesRead(), encoded.size());
+        BOOST_CHECK(stream.empty());
+
+        // Reading past the end of the data fails.
+        encoded.resize(encoded.size() / 2);
+        GolombRiceReader truncated{encoded};
+        BOOST_CHECK_THROW(for (size_t i = 0; i < values.size(); ++i) truncated.Decode(P), std::ios_base::failure);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(gcsfilter_match_any_many)
+{
+    std::vector<GCSFilter> filters;
+    std::vector<GCSFilter::ElementSet> filter_elements;
+    for (uint64_t n = 0; n < 8; ++n) {
+        GCSFilter::ElementSet elements;
+        for (int i = 0; i < 50; ++i) {
+            GCSFilter::Element element(32);
+            element[0] = n;
+            element[1] = i;
+            elements.insert(std::move(element));
+        }
+        filters.emplace_back(GCSFilter::Params{n, n, BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+        filter_elements.push_back(std::move(elements));
+    }
+    std::vector<const GCSFilter*> filter_ptrs;
+    for (const auto& filter : filters) filter_ptrs.push_back(&filter);
+
+    // Query sets both smaller and larger than the filters, matching filters 2 and 5.
+    for (const int query_size : {10, 200}) {
+        GCSFilter::ElementSet query;
+        for (int i = 0; i < query_size; ++i) {
+            GCSFilter::Element element(32);
+            element[0] = 0xff;
+            element[1] = i;
+            query.insert(std::move(element));
+        }
+        query.insert(*filter_elements[2].begin());
+        query.insert(*filter_elements[5].begin());
+
+        const std::vector<bool> matches{GCSFilter::MatchAnyMany(filter_ptrs, query)};
+        BOOST_REQUIRE_EQUAL(matches.size(), filters.size());
+        for (size_t n = 0; n < filters.size(); ++n) {
+            BOOST_CHECK_EQUAL(matches[n], filters[n].MatchAny(query));
+            if (n == 2 || n == 5) BOOST_CHECK(matches[n]);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(gcsfilter_default_constructor)
 {
     GCSFilter filter;
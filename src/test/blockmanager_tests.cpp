@@ -9,6 +9,7 @@
 #include <node/kernel_notifications.h>
 #include <script/solver.h>
 #include <primitives/block.h>
+#include <streams.h>
 #include <util/chaintype.h>
 #include <validation.h>
 
@@ -16,6 +17,8 @@
 #include <test/util/logging.h>
 #include <test/util/setup_common.h>
 
+#include <algorithm>
+
 using node::BLOCK_SERIALIZATION_HEADER_SIZE;
 using node::BlockManager;
 using node::KernelNotifications;
@@ -201,4 +204,58 @@ BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
     BOOST_CHECK_EQUAL(read_block.nVersion, 2);
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_mmap_read)
+{
+    KernelNotifications notifications{*Assert(m_node.shutdown), m_node.exit_status};
+    const BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .use_mmap = true,
+    };
+    BlockManager blockman{*Assert(m_node.shutdown), blockman_opts};
+
+    CBlock block1;
+    block1.nVersion = 1;
+    CBlock block2;
+    block2.nVersion = 2;
+    DataStream stream;
+    stream << TX_WITH_WITNESS(block1);
+    const auto expected{MakeUCharSpan(stream)};
+
+    // The block file is still being written to, so it is not mapped
+    const FlatFilePos pos1{blockman.SaveBlockToDisk(block1, /*nHeight=*/1, /*dbp=*/nullptr)};
+    BOOST_CHECK(!blockman.MapRawBlock(pos1));
+
+    // Cap the block file, so that the next block starts a new one and this one is finalized
+    blockman.GetBlockFileInfo(pos1.nFile)->nSize = MAX_BLOCKFILE_SIZE;
+    const FlatFilePos pos2{blockman.SaveBlockToDisk(block2, /*nHeight=*/2, /*dbp=*/nullptr)};
+    BOOST_CHECK_NE(pos1.nFile, pos2.nFile);
+    BOOST_CHECK(!blockman.MapRawBlock(pos2));
+
+    const auto mapped{blockman.MapRawBlock(pos1)};
+    BOOST_REQUIRE(mapped);
+    BOOST_CHECK(std::equal(mapped->data.begin(), mapped->data.end(), expected.begin(), expected.end()));
+    std::vector<uint8_t> raw_block;
+    BOOST_CHECK(blockman.ReadRawBlockFromDisk(raw_block, pos1));
+    BOOST_CHECK(std::equal(raw_block.begin(), raw_block.end(), expected.begin(), expected.end()));
+
+    // The block is deserialized from the mapping, the error is about the junk block data
+    CBlock read_block;
+    {
+        ASSERT_DEBUG_LOG("ReadBlockFromDisk: Errors in block header");
+        BOOST_CHECK(!blockman.ReadBlockFromDisk(read_block, pos1));
+        BOOST_CHECK_EQUAL(read_block.nVersion, 1);
+    }
+
+    // A position that does not follow a block header is left to the file reader
+    BOOST_CHECK(!blockman.MapRawBlock(FlatFilePos{pos1.nFile, pos1.nPos + 1}));
+    BOOST_CHECK(!blockman.ReadRawBlockFromDisk(raw_block, FlatFilePos{pos1.nFile, pos1.nPos + 1}));
+
+    // Pruning the file drops the mapping, which stays valid while it is still in use
+    blockman.UnlinkPrunedFiles({pos1.nFile});
+    BOOST_CHECK(!blockman.MapRawBlock(pos1));
+    BOOST_CHECK(std::equal(mapped->data.begin(), mapped->data.end(), expected.begin(), expected.end()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
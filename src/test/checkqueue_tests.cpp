@@ -64,6 +64,15 @@ struct FailingCheck {
     }
 };
 
+struct CountingFailingCheck {
+    static std::atomic<size_t> n_calls;
+    bool operator()()
+    {
+        n_calls.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+};
+
 struct UniqueCheck {
     static Mutex m;
     static std::unordered_multiset<size_t> results GUARDED_BY(m);
@@ -142,12 +151,14 @@ std::condition_variable FrozenCleanupCheck::cv{};
 Mutex UniqueCheck::m;
 std::unordered_multiset<size_t> UniqueCheck::results;
 std::atomic<size_t> FakeCheckCheckCompletion::n_calls{0};
+std::atomic<size_t> CountingFailingCheck::n_calls{0};
 std::atomic<size_t> MemoryCheck::fake_allocated_memory{0};
 
 // Queue Typedefs
 typedef CCheckQueue<FakeCheckCheckCompletion> Correct_Queue;
 typedef CCheckQueue<FakeCheck> Standard_Queue;
 typedef CCheckQueue<FailingCheck> Failing_Queue;
+typedef CCheckQueue<CountingFailingCheck> CountingFailing_Queue;
 typedef CCheckQueue<UniqueCheck> Unique_Queue;
 typedef CCheckQueue<MemoryCheck> Memory_Queue;
 typedef CCheckQueue<FrozenCleanupCheck> FrozenCleanup_Queue;
@@ -286,6 +297,48 @@ BOOST_AUTO_TEST_CASE(test_CheckQueue_UniqueCheck)
     }
 }
 
+// Test that checks added in one large batch are all called exactly once, when
+// the other threads have to steal them from the thread the batch was given to.
+BOOST_AUTO_TEST_CASE(test_CheckQueue_UniqueCheck_Stealing)
+{
+    auto queue = std::make_unique<Unique_Queue>(QUEUE_BATCH_SIZE, SCRIPT_CHECK_THREADS);
+    const size_t COUNT = 100000;
+    WITH_LOCK(UniqueCheck::m, UniqueCheck::results.clear());
+    {
+        CCheckQueueControl<UniqueCheck> control(queue.get());
+        std::vector<UniqueCheck> vChecks;
+        vChecks.reserve(COUNT);
+        for (size_t i = 0; i < COUNT; ++i) {
+            vChecks.emplace_back(i);
+        }
+        control.Add(std::move(vChecks));
+        BOOST_REQUIRE(control.Wait());
+    }
+    {
+        LOCK(UniqueCheck::m);
+        bool r = true;
+        BOOST_REQUIRE_EQUAL(UniqueCheck::results.size(), COUNT);
+        for (size_t i = 0; i < COUNT; ++i) {
+            r = r && UniqueCheck::results.count(i) == 1;
+        }
+        BOOST_REQUIRE(r);
+    }
+}
+
+// Test that once a check failed, the remaining checks are not called.
+BOOST_AUTO_TEST_CASE(test_CheckQueue_Stops_After_Failure)
+{
+    CountingFailingCheck::n_calls = 0;
+
+    // Without worker threads, the master runs the checks one by one in Wait().
+    CountingFailing_Queue queue{QUEUE_BATCH_SIZE, /*worker_threads_num=*/0};
+    for (int i = 0; i < 10; ++i) {
+        CCheckQueueControl<CountingFailingCheck> control(&queue);
+        control.Add(std::vector<CountingFailingCheck>(1000));
+        BOOST_REQUIRE(!control.Wait());
+    }
+    BOOST_CHECK_EQUAL(CountingFailingCheck::n_calls, 10U);
+}
 
 // Test that blocks which might allocate lots of memory free their memory aggressively.
 //
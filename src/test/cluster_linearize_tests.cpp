@@ -0,0 +1,105 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <cluster_linearize.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace cluster_linearize;
+
+BOOST_FIXTURE_TEST_SUITE(cluster_linearize_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(feefrac_compare)
+{
+    BOOST_CHECK(FeeFrac(1000, 100).HigherFeerateThan(FeeFrac(999, 100)));
+    BOOST_CHECK(!FeeFrac(1000, 100).HigherFeerateThan(FeeFrac(2000, 200)));
+    BOOST_CHECK(FeeFrac(0, 100).HigherFeerateThan(FeeFrac(-1, 100)));
+    // Products past 2^53, which differ by one: (2^53 + 1) * 3 > 2^53 * 3.
+    const int64_t big{int64_t{1} << 53};
+    BOOST_CHECK(FeeFrac(big + 1, 3).HigherFeerateThan(FeeFrac(big, 3)));
+    BOOST_CHECK(!FeeFrac(big, 3).HigherFeerateThan(FeeFrac(big + 1, 3)));
+    // Products past 2^63.
+    const int64_t max_fee{std::numeric_limits<int64_t>::max()};
+    BOOST_CHECK(FeeFrac(max_fee, 1000000).HigherFeerateThan(FeeFrac(max_fee - 1, 1000000)));
+    BOOST_CHECK(!FeeFrac(max_fee, 1000001).HigherFeerateThan(FeeFrac(max_fee, 1000000)));
+}
+
+BOOST_AUTO_TEST_CASE(linearize_cpfp)
+{
+    // A low fee parent with a high fee child, and an unrelated medium fee transaction.
+    const std::vector<FeeFrac> feerates{{100, 100}, {1000, 100}, {300, 100}};
+    const std::vector<std::vector<uint32_t>> parents{{}, {0}, {}};
+
+    const auto linearization{Linearize(feerates, parents)};
+    BOOST_CHECK((linearization == std::vector<uint32_t>{0, 1, 2}));
+
+    const auto chunks{ChunkLinearization(feerates, linearization)};
+    BOOST_REQUIRE_EQUAL(chunks.size(), 2U);
+    // Parent and child are mined together, at their combined feerate.
+    BOOST_CHECK_EQUAL(chunks[0].first.fee, 1100);
+    BOOST_CHECK_EQUAL(chunks[0].first.size, 200);
+    BOOST_CHECK_EQUAL(chunks[0].second, 2U);
+    BOOST_CHECK_EQUAL(chunks[1].first.fee, 300);
+    BOOST_CHECK_EQUAL(chunks[1].second, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(linearize_independent)
+{
+    const std::vector<FeeFrac> feerates{{200, 100}, {500, 250}, {900, 100}, {100, 400}};
+    const std::vector<std::vector<uint32_t>> parents(feerates.size());
+
+    const auto linearization{Linearize(feerates, parents)};
+    BOOST_CHECK((linearization == std::vector<uint32_t>{2, 0, 1, 3}) || (linearization == std::vector<uint32_t>{2, 1, 0, 3}));
+
+    // Transactions of equal feerate are merged into one chunk.
+    const auto chunks{ChunkLinearization(feerates, linearization)};
+    BOOST_REQUIRE_EQUAL(chunks.size(), 3U);
+    BOOST_CHECK_EQUAL(chunks[1].second, 2U);
+}
+
+BOOST_AUTO_TEST_CASE(linearize_random)
+{
+    for (int iter{0}; iter < 100; ++iter) {
+        const uint32_t n{1 + uint32_t(InsecureRandRange(150))};
+        std::vector<FeeFrac> feerates;
+        std::vector<std::vector<uint32_t>> parents(n);
+        for (uint32_t i{0}; i < n; ++i) {
+            feerates.emplace_back(InsecureRandRange(100000), 60 + InsecureRandRange(1000));
+            for (uint32_t j{0}; j < i; ++j) {
+                if (InsecureRandRange(i) < 2) parents[i].push_back(j);
+            }
+        }
+
+        const auto linearization{Linearize(feerates, parents)};
+        BOOST_REQUIRE_EQUAL(linearization.size(), n);
+        // Every transaction appears once, after all of its parents.
+        std::vector<bool> seen(n);
+        for (uint32_t i : linearization) {
+            BOOST_CHECK(!seen[i]);
+            for (uint32_t parent : parents[i]) BOOST_CHECK(seen[parent]);
+            seen[i] = true;
+        }
+
+        const auto chunks{ChunkLinearization(feerates, linearization)};
+        FeeFrac total, chunk_total;
+        uint32_t count{0};
+        for (const FeeFrac& feerate : feerates) total += feerate;
+        for (size_t i{0}; i < chunks.size(); ++i) {
+            if (i > 0) BOOST_CHECK(chunks[i - 1].first.HigherFeerateThan(chunks[i].first));
+            chunk_total += chunks[i].first;
+            count += chunks[i].second;
+        }
+        BOOST_CHECK_EQUAL(count, n);
+        BOOST_CHECK_EQUAL(chunk_total.fee, total.fee);
+        BOOST_CHECK_EQUAL(chunk_total.size, total.size);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
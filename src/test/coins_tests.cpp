@@ -6,7 +6,6 @@
 #include <clientversion.h>
 #include <coins.h>
 #include <streams.h>
-#include <test/util/poolresourcetester.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
 #include <txdb.h>
@@ -282,6 +281,10 @@ BOOST_AUTO_TEST_CASE(coins_cache_simulation_test)
 
     CCoinsViewDB db_base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
     SimulationTest(&db_base, true);
+
+    CCoinsViewDB async_db{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
+    CCoinsViewAsyncFlush async_base{&async_db};
+    SimulationTest(&async_base, true);
 }
 
 // Store of all necessary tx and undo data for next test
@@ -613,8 +616,7 @@ void GetCoinsMapEntry(const CCoinsMap& map, CAmount& value, char& flags, const C
 
 void WriteCoinsViewEntry(CCoinsView& view, CAmount value, char flags)
 {
-    CCoinsMapMemoryResource resource;
-    CCoinsMap map{0, CCoinsMap::hasher{}, CCoinsMap::key_equal{}, &resource};
+    CCoinsMap map{CCoinsMap::hasher{}};
     InsertCoinsMapEntry(map, value, flags);
     BOOST_CHECK(view.BatchWrite(map, {}));
 }
@@ -1084,29 +1086,119 @@ BOOST_AUTO_TEST_CASE(ccoins_flush_behavior)
     }
 }
 
-BOOST_AUTO_TEST_CASE(coins_resource_is_used)
+BOOST_AUTO_TEST_CASE(ccoins_async_flush)
 {
-    CCoinsMapMemoryResource resource;
-    PoolResourceTester::CheckAllDataAccountedFor(resource);
+    CCoinsViewDB db{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
+    CCoinsViewAsyncFlush async{&db};
+    CCoinsViewCacheTest cache{&async};
+
+    std::vector<COutPoint> outpoints;
+    for (int i = 0; i < 1000; ++i) {
+        outpoints.emplace_back(Txid::FromUint256(InsecureRand256()), i);
+        cache.AddCoin(outpoints.back(), Coin{CTxOut{i + 1, CScript{} << OP_TRUE}, 1, false}, /*possible_overwrite=*/false);
+    }
+    const uint256 block1{InsecureRand256()};
+    cache.SetBestBlock(block1);
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 0U);
+
+    // While (or after) the snapshot is written, the cache sees all flushed coins.
+    BOOST_CHECK(cache.GetBestBlock() == block1);
+    for (size_t i = 0; i < outpoints.size(); i += 2) {
+        BOOST_CHECK(cache.HaveCoin(outpoints[i]));
+        cache.SpendCoin(outpoints[i]);
+    }
+    const uint256 block2{InsecureRand256()};
+    cache.SetBestBlock(block2);
+    // The second flush waits for the first write before handing over its coins.
+    BOOST_CHECK(cache.Flush());
 
+    // A cursor taken while the write may be in progress sees the database
+    // either before or after it, never in between.
     {
-        CCoinsMap map{0, CCoinsMap::hasher{}, CCoinsMap::key_equal{}, &resource};
-        BOOST_TEST(memusage::DynamicUsage(map) >= resource.ChunkSizeBytes());
+        const auto cursor{db.Cursor()};
+        size_t count{0};
+        for (; cursor->Valid(); cursor->Next()) ++count;
+        BOOST_CHECK(cursor->GetBestBlock() == block1 || cursor->GetBestBlock() == block2);
+        BOOST_CHECK_EQUAL(count, cursor->GetBestBlock() == block1 ? outpoints.size() : outpoints.size() / 2);
+    }
+    BOOST_CHECK(async.WaitForWrite());
+    BOOST_CHECK(!async.IsWriting());
 
-        map.reserve(1000);
+    BOOST_CHECK(db.GetBestBlock() == block2);
+    for (size_t i = 0; i < outpoints.size(); ++i) {
+        BOOST_CHECK_EQUAL(db.HaveCoin(outpoints[i]), i % 2 == 1);
+        BOOST_CHECK_EQUAL(cache.HaveCoin(outpoints[i]), i % 2 == 1);
+    }
+}
 
-        // The resource has preallocated a chunk, so we should have space for at several nodes without the need to allocate anything else.
-        const auto usage_before = memusage::DynamicUsage(map);
+BOOST_AUTO_TEST_CASE(ccoins_range_cursors)
+{
+    CCoinsViewDB db{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
+    CCoinsViewCacheTest cache{&db};
+
+    // Include txids at both ends of the key space, and several outputs of the same transaction.
+    uint256 max_txid;
+    std::fill(max_txid.begin(), max_txid.end(), 0xff);
+    std::vector<Txid> txids{Txid::FromUint256(uint256::ZERO), Txid::FromUint256(max_txid)};
+    for (int i = 0; i < 500; ++i) {
+        txids.push_back(Txid::FromUint256(InsecureRand256()));
+    }
+    for (const Txid& txid : txids) {
+        for (uint32_t n = 0; n < 3; ++n) {
+            cache.AddCoin(COutPoint{txid, n}, Coin{CTxOut{n + 1, CScript{} << OP_TRUE}, 1, false}, /*possible_overwrite=*/false);
+        }
+    }
+    cache.SetBestBlock(InsecureRand256());
+    BOOST_REQUIRE(cache.Flush());
 
-        COutPoint out_point{};
-        for (size_t i = 0; i < 1000; ++i) {
-            out_point.n = i;
-            map[out_point];
+    std::vector<COutPoint> all;
+    for (auto cursor{db.Cursor()}; cursor->Valid(); cursor->Next()) {
+        BOOST_REQUIRE(cursor->GetKey(all.emplace_back()));
+    }
+    BOOST_CHECK_EQUAL(all.size(), txids.size() * 3);
+
+    // The ranges are disjoint and together iterate over all coins in order.
+    for (size_t num_ranges : {1, 2, 7, 256, 1000}) {
+        const auto cursors{db.RangeCursors(num_ranges)};
+        BOOST_CHECK_EQUAL(cursors.size(), num_ranges);
+        std::vector<COutPoint> ranges;
+        for (const auto& cursor : cursors) {
+            BOOST_CHECK(cursor->GetBestBlock() == db.GetBestBlock());
+            for (; cursor->Valid(); cursor->Next()) {
+                Coin coin;
+                BOOST_REQUIRE(cursor->GetKey(ranges.emplace_back()));
+                BOOST_REQUIRE(cursor->GetValue(coin));
+                BOOST_CHECK_EQUAL(coin.out.nValue, ranges.back().n + 1);
+            }
         }
-        BOOST_TEST(usage_before == memusage::DynamicUsage(map));
+        BOOST_CHECK(ranges == all);
     }
 
-    PoolResourceTester::CheckAllDataAccountedFor(resource);
+    // Views on top of the database forward the ranges, but the cache cannot iterate.
+    CCoinsViewAsyncFlush async{&db};
+    BOOST_CHECK_EQUAL(async.RangeCursors(4).size(), 4U);
+    BOOST_CHECK_THROW(cache.RangeCursors(4), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(coins_map_reserve_is_used)
+{
+    CCoinsMap map{CCoinsMap::hasher{}};
+    BOOST_TEST(memusage::DynamicUsage(map) == 0U);
+
+    map.reserve(1000);
+
+    // The table has been allocated up front, so inserting 1000 coins must not cause a rehash.
+    const auto usage_before = memusage::DynamicUsage(map);
+    BOOST_TEST(usage_before >= 1000 * sizeof(CCoinsMap::value_type));
+
+    COutPoint out_point{};
+    for (size_t i = 0; i < 1000; ++i) {
+        out_point.n = i;
+        map[out_point];
+    }
+    BOOST_TEST(map.size() == 1000U);
+    BOOST_TEST(usage_before == memusage::DynamicUsage(map));
 }
 
 BOOST_AUTO_TEST_SUITE_END()
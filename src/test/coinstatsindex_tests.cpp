@@ -118,4 +118,32 @@ BOOST_FIXTURE_TEST_CASE(coinstatsindex_unclean_shutdown, TestChain100Setup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(coinstats_worker_threads, TestChain100Setup)
+{
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    CCoinsViewDB* coins_db{WITH_LOCK(cs_main, chainstate.ForceFlushStateToDisk(); return &chainstate.CoinsDB())};
+
+    // Statistics computed on several threads are the same as on a single one.
+    for (const auto hash_type : {kernel::CoinStatsHashType::HASH_SERIALIZED, kernel::CoinStatsHashType::MUHASH, kernel::CoinStatsHashType::NONE}) {
+        const auto stats{kernel::ComputeUTXOStats(hash_type, coins_db, m_node.chainman->m_blockman)};
+        const auto parallel_stats{kernel::ComputeUTXOStats(hash_type, coins_db, m_node.chainman->m_blockman, {}, /*worker_threads_num=*/3)};
+        BOOST_REQUIRE(stats && parallel_stats);
+        BOOST_CHECK_EQUAL(parallel_stats->nHeight, stats->nHeight);
+        BOOST_CHECK(parallel_stats->hashBlock == stats->hashBlock);
+        BOOST_CHECK_EQUAL(parallel_stats->nTransactions, stats->nTransactions);
+        BOOST_CHECK_EQUAL(parallel_stats->nTransactionOutputs, stats->nTransactionOutputs);
+        BOOST_CHECK_EQUAL(parallel_stats->nBogoSize, stats->nBogoSize);
+        BOOST_CHECK_EQUAL(parallel_stats->coins_count, stats->coins_count);
+        BOOST_CHECK(parallel_stats->total_amount == stats->total_amount);
+        BOOST_CHECK(parallel_stats->hashSerialized == stats->hashSerialized);
+        BOOST_CHECK_EQUAL(stats->nTransactions, 100U);
+    }
+
+    // An exception thrown by the interruption point on a worker thread is
+    // rethrown on the calling thread.
+    BOOST_CHECK_THROW(kernel::ComputeUTXOStats(kernel::CoinStatsHashType::MUHASH, coins_db, m_node.chainman->m_blockman,
+                                               [] { throw std::runtime_error("interrupted"); }, /*worker_threads_num=*/3),
+                      std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
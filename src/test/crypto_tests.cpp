@@ -838,6 +838,43 @@ BOOST_AUTO_TEST_CASE(chacha20_midblock)
     BOOST_CHECK(Span{block}.last(52) == Span{b3});
 }
 
+BOOST_AUTO_TEST_CASE(chacha20_multiblock)
+{
+    // Long Keystream/Crypt calls are processed several blocks at a time. Compare them against
+    // producing one block per call, including around the block counter overflow.
+    const auto key{g_insecure_rand_ctx.randbytes<std::byte>(ChaCha20Aligned::KEYLEN)};
+    const ChaCha20Aligned::Nonce96 nonce{InsecureRand32(), g_insecure_rand_ctx.rand64()};
+    for (const uint32_t seek : {uint32_t{0}, uint32_t{0xfffffff0}, uint32_t{0xfffffffb}}) {
+        for (size_t blocks = 1; blocks <= 21; ++blocks) {
+            const size_t len{blocks * ChaCha20Aligned::BLOCKLEN};
+            const auto msg{g_insecure_rand_ctx.randbytes<std::byte>(len)};
+
+            ChaCha20Aligned single{key};
+            single.Seek(nonce, seek);
+            std::vector<std::byte> expected_stream(len), expected_crypt(len);
+            for (size_t i = 0; i < blocks; ++i) {
+                single.Keystream(Span{expected_stream}.subspan(i * ChaCha20Aligned::BLOCKLEN, ChaCha20Aligned::BLOCKLEN));
+            }
+            for (size_t i = 0; i < len; ++i) expected_crypt[i] = msg[i] ^ expected_stream[i];
+
+            ChaCha20Aligned multi{key};
+            std::vector<std::byte> out(len);
+            multi.Seek(nonce, seek);
+            multi.Keystream(out);
+            BOOST_CHECK(out == expected_stream);
+            multi.Seek(nonce, seek);
+            multi.Crypt(msg, out);
+            BOOST_CHECK(out == expected_crypt);
+
+            // Both continue at the same position afterwards.
+            std::byte next_single[ChaCha20Aligned::BLOCKLEN], next_multi[ChaCha20Aligned::BLOCKLEN];
+            single.Keystream(next_single);
+            multi.Keystream(next_multi);
+            BOOST_CHECK(Span{next_single} == Span{next_multi});
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(poly1305_testvector)
 {
     // RFC 7539, section 2.5.2.
@@ -1098,6 +1135,25 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256d_many)
+{
+    for (int count = 0; count <= 40; ++count) {
+        std::vector<std::vector<unsigned char>> msgs(count);
+        std::vector<const unsigned char*> inputs(count);
+        std::vector<size_t> lengths(count);
+        std::vector<unsigned char> out1(32 * count), out2(32 * count);
+        for (int i = 0; i < count; ++i) {
+            // Cover empty messages and lengths around the one- and two-block padding boundaries.
+            msgs[i] = g_insecure_rand_ctx.randbytes(InsecureRandRange(300));
+            inputs[i] = msgs[i].data();
+            lengths[i] = msgs[i].size();
+            CHash256().Write(msgs[i]).Finalize({out1.data() + 32 * i, 32});
+        }
+        SHA256DMany(out2.data(), inputs.data(), lengths.data(), count);
+        BOOST_CHECK(out1 == out2);
+    }
+}
+
 static void TestSHA3_256(const std::string& input, const std::string& output)
 {
     const auto in_bytes = ParseHex(input);